@@ -128,6 +128,11 @@ CommandLine::CommandLine(int argc, const char** argv) {
           }
         }
       }
+    else if(arg=="-workers") {
+      ++i;
+      if(i<argc)
+        workers = uint32_t(std::max(0, intArg(argv[i])));
+      }
     else if(arg=="-gi") {
       ++i;
       if(i<argc) {
@@ -169,6 +169,28 @@ void MoveAlgo::tick(uint64_t dt, MvFlags moveFlg) {
     }
   }
 
+void MoveAlgo::prefetch(Prefetch& out, uint64_t dt) const {
+  // same motion as implTick, if nothing interrupts it; implTick falls back to own rays otherwise
+  out = Prefetch();
+  if(npc.interactive()!=nullptr || flags==ClimbUp || flags==JumpUp)
+    return;
+
+  const bool grav = (flags==InAir || flags==Falling);
+  const auto dp   = (!grav && flags!=Slide) ? animMoveSpeed(dt) : fallSpeed*float(dt);
+  if(dp==Tempest::Vec3())
+    return; // standing: cache is valid already
+
+  const auto  physic    = npc.owner.physic();
+  const auto  pos       = npc.position()+dp;
+  const float fallY     = grav ? fallSpeed.y-gravity*float(dt) : fallSpeed.y;
+  const float threshold = npc.physic.groundOffset() + 1.f;
+
+  out.at     = pos;
+  out.landDy = (fallY<0) ? 0 : threshold+100;
+  out.land   = physic->landRay(Tempest::Vec3(pos.x, pos.y+threshold, pos.z), out.landDy);
+  out.water  = physic->waterRay(pos, stepHeight());
+  }
+
 bool MoveAlgo::implTick(uint64_t dt, MvFlags moveFlg) {
   if(flags==ClimbUp) {
     tickClimb(dt);
@@ -1034,10 +1056,14 @@ float MoveAlgo::waterRay(const Tempest::Vec3& pos) const {
   if(std::fabs(cacheW.x-pos.x)>eps || std::fabs(cacheW.y-pos.y)>eps || std::fabs(cacheW.z-pos.z)>eps) {
     // const float threshold = canFlyOverWater() ? -stepHeight() : -0.1f;
     const auto  spos      = pos; //Tempest::Vec3(pos.x, pos.y+threshold, pos.z);
-    static_cast<DynamicWorld::RayWaterResult&>(cacheW) = npc.world().physic()->waterRay(spos, stepHeight());
-    cacheW.x = pos.x;
-    cacheW.y = pos.y;
-    cacheW.z = pos.z;
+    const bool  pre       = isPrefetched(pos);
+    const auto  at        = pre ? pf.at : pos;
+    if(pre)
+      static_cast<DynamicWorld::RayWaterResult&>(cacheW) = pf.water; else
+      static_cast<DynamicWorld::RayWaterResult&>(cacheW) = npc.world().physic()->waterRay(spos, stepHeight());
+    cacheW.x = at.x;
+    cacheW.y = at.y;
+    cacheW.z = at.z;
     }
   return cacheW.wdepth;
   }
@@ -1049,13 +1075,35 @@ void MoveAlgo::rayMain(const Tempest::Vec3& pos) const {
     if(fallSpeed.y<0 || false)
       dy = 0; // whole world
     const auto spos = Tempest::Vec3(pos.x, pos.y+threshold, pos.z);
-    static_cast<DynamicWorld::RayLandResult&>(cache) = npc.world().physic()->landRay(spos,dy);
-    cache.x = pos.x;
-    cache.y = pos.y;
-    cache.z = pos.z;
+    const bool pre  = isPrefetched(pos) && pf.landDy==dy;
+    const auto at   = pre ? pf.at : pos;
+    if(pre)
+      static_cast<DynamicWorld::RayLandResult&>(cache) = pf.land; else
+      static_cast<DynamicWorld::RayLandResult&>(cache) = npc.world().physic()->landRay(spos,dy);
+    cache.x = at.x;
+    cache.y = at.y;
+    cache.z = at.z;
     }
   }
 
+bool MoveAlgo::isPrefetched(const Tempest::Vec3& pos) const {
+  return std::fabs(pf.at.x-pos.x)<=eps && std::fabs(pf.at.y-pos.y)<=eps && std::fabs(pf.at.z-pos.z)<=eps;
+  }
+
+bool MoveAlgo::Prefetch::operator == (const Prefetch& other) const {
+  return at              ==other.at &&
+         landDy          ==other.landDy &&
+         land.v          ==other.land.v &&
+         land.n          ==other.land.n &&
+         land.mat        ==other.land.mat &&
+         land.hasCol     ==other.land.hasCol &&
+         land.hitFraction==other.land.hitFraction &&
+         land.sector     ==other.land.sector &&
+         land.vob        ==other.land.vob &&
+         water.wdepth    ==other.water.wdepth &&
+         water.hasCol    ==other.water.hasCol;
+  }
+
 float MoveAlgo::dropRay(const Tempest::Vec3& pos, bool &hasCol) const {
   rayMain(pos);
   hasCol = cache.hasCol;
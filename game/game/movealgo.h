@@ -47,6 +47,15 @@ class MoveAlgo final {
       Dive,
       };
 
+    // ground and water probes at position, expected after next tick: taken in parallel phase of tick
+    struct Prefetch final {
+      DynamicWorld::RayLandResult  land;
+      DynamicWorld::RayWaterResult water;
+      Tempest::Vec3                at     = {0,0,std::numeric_limits<float>::infinity()};
+      float                        landDy = 0;
+      bool operator == (const Prefetch& other) const;
+      };
+
     static bool isClose(const Npc& npc, const Npc& p, float dist);
     static bool isClose(const Npc& npc, const WayPoint& p);
     static bool isClose(const Npc& npc, const WayPoint& p, float dist);
@@ -56,6 +65,8 @@ class MoveAlgo final {
     void    save(Serialize& fout) const;
 
     void    tick(uint64_t dt, MvFlags fai=NoFlag);
+    void    prefetch(Prefetch& out, uint64_t dt) const;
+    void    setPrefetch(const Prefetch& p) { pf = p; }
 
     void    multSpeed(float s){ mulSpeed=s; }
     void    clearSpeed();
@@ -131,6 +142,7 @@ class MoveAlgo final {
     float   dropRay  (const Tempest::Vec3& pos, bool& hasCol) const;
     float   waterRay (const Tempest::Vec3& pos) const;
     auto    normalRay(const Tempest::Vec3& pos) const -> Tempest::Vec3;
+    bool    isPrefetched(const Tempest::Vec3& pos) const;
 
     struct CacheLand : DynamicWorld::RayLandResult {
       float x=0, y=0, z=std::numeric_limits<float>::infinity();
@@ -142,6 +154,7 @@ class MoveAlgo final {
     Npc&                npc;
     mutable CacheLand   cache;
     mutable CacheWater  cacheW;
+    Prefetch            pf;
 
     std::string_view    portal;
     std::string_view    formerPortal;
@@ -17,10 +17,12 @@
 #include "game/definitions/particlesdefinitions.h"
 
 #include "world/objects/npc.h"
+#include "graphics/mesh/animmath.h"
 #include "graphics/shaders.h"
 
 #include "utils/fileutil.h"
 #include "utils/inifile.h"
+#include "utils/workers.h"
 
 #include "commandline.h"
 #include "mainwindow.h"
@@ -72,9 +74,21 @@ Gothic::Gothic() {
   opts.showManaBar       = uint8_t(std::clamp(systemPackIniFile->getI("INTERFACE","ShowManaBar",1), 0, 2));
   opts.showSwimBar       = uint8_t(std::clamp(systemPackIniFile->getI("INTERFACE","ShowSwimBar",1), 0, 2));
 
+  opts.aiFarInterval  = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AiFarTickInterval", int(opts.aiFarInterval))));
+  opts.aiFar2Interval = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AiFar2TickInterval",int(opts.aiFar2Interval))));
+  opts.aiFarBudget    = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AiFarBudget",       int(opts.aiFarBudget))));
+
+  opts.animLodNear        = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AnimLodNearDistance",int(opts.animLodNear))));
+  opts.animLodFar         = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AnimLodFarDistance", int(opts.animLodFar))));
+  opts.animLodInterval    = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AnimLodInterval",    int(opts.animLodInterval))));
+  opts.animLodFarInterval = uint32_t(std::max(0, systemPackIniFile->getI("PARAMETERS","AnimLodFarInterval", int(opts.animLodFarInterval))));
+  opts.animLodFreeze      = systemPackIniFile->getI("PARAMETERS","AnimLodFreezeOffscreen",opts.animLodFreeze ? 1 : 0)!=0;
+
 #ifndef NDEBUG
   setMarvinEnabled(true);
   setFRate(true);
+  [[maybe_unused]] const bool animMathOk = animMathSelfCheck();
+  assert(animMathOk);
 #else
   setMarvinEnabled(CommandLine::inst().isDevMode());
   setFRate(CommandLine::inst().isBenchmarkMode()!=Benchmark::None);
@@ -184,6 +198,16 @@ Gothic::Gothic() {
   defaults->set("KEYS", "keyShowStatus",  "30002e00");
   defaults->set("KEYS", "keyShowLog",     "31002600");
   defaults->set("KEYS", "keyShowMap",     "3200");
+
+  defaults->set("SYSTEM", "workerThreads",  0); // autodetect
+  defaults->set("SYSTEM", "workerAffinity", 0);
+  }
+
+  {
+  uint32_t threads = CommandLine::inst().workerThreads();
+  if(threads==0)
+    threads = uint32_t(std::max(0, settingsGetI("SYSTEM","workerThreads")));
+  Workers::setup(threads, settingsGetI("SYSTEM","workerAffinity")!=0);
   }
 
   detectGothicVersion();
@@ -66,6 +66,16 @@ class Gothic final {
       bool     showHealthBar     = true;
       uint8_t  showManaBar       = 2;
       uint8_t  showSwimBar       = 1;
+
+      uint32_t aiFarInterval     = 100;  // ms, between ticks of AiFar npc
+      uint32_t aiFar2Interval    = 400;  // ms, between ticks of AiFar2 npc
+      uint32_t aiFarBudget       = 1000; // us, per frame for all far npc
+
+      uint32_t animLodNear        = 2000; // cm, skeletons closer than that are sampled every frame
+      uint32_t animLodFar         = 5000; // cm
+      uint32_t animLodInterval    = 50;   // ms, between pose samples in [near,far]
+      uint32_t animLodFarInterval = 150;  // ms, between pose samples beyond far
+      bool     animLodFreeze      = true; // off-screen skeletons beyond near are not sampled, unless gameplay reads bones
       };
 
     auto         version() const -> const VersionInfo&;
@@ -39,47 +39,64 @@ static bool bitAt(std::vector<uint32_t>& b, size_t id) {
 using namespace Tempest;
 
 InstanceStorage::Id::Id(Id&& other) noexcept
-  :owner(other.owner), rgn(other.rgn) {
+  :owner(other.owner), rgn(other.rgn), streamEpoch(other.streamEpoch), streamRec(other.streamRec), streamSrc(other.streamSrc) {
   other.owner = nullptr;
   }
 
 InstanceStorage::Id& InstanceStorage::Id::operator = (Id&& other) noexcept {
-  std::swap(owner, other.owner);
-  std::swap(rgn,   other.rgn);
+  std::swap(owner,       other.owner);
+  std::swap(rgn,         other.rgn);
+  std::swap(streamEpoch, other.streamEpoch);
+  std::swap(streamRec,   other.streamRec);
+  std::swap(streamSrc,   other.streamSrc);
   return *this;
   }
 
 InstanceStorage::Id::~Id() {
-  if(owner!=nullptr)
+  if(owner!=nullptr) {
+    owner->implUnstream(*this);
     owner->free(rgn);
+    }
   }
 
 void InstanceStorage::Id::set(const Tempest::Matrix4x4* mat) {
   if(owner==nullptr)
     return;
 
+  // written to staging slice only; dataCpu stays stale, while region is streamed
+  if(owner->implStream(*this, mat))
+    return;
+
   auto data = reinterpret_cast<Matrix4x4*>(owner->dataCpu.data() + rgn.begin);
   std::memcpy(data, mat, rgn.asize);
-
+  owner->streamed[rgn.begin/blockSz] = 0;
   for(size_t i=0; i<rgn.asize; i+=blockSz)
-    bitSet(owner->durty, (rgn.begin+i)/blockSz);
+    owner->implDurty((rgn.begin+i)/blockSz);
   }
 
 void InstanceStorage::Id::set(const Tempest::Matrix4x4& obj, size_t offset) {
   if(owner==nullptr)
     return;
 
+  if(owner->implPatchStream(*this, &obj, offset*sizeof(Matrix4x4), sizeof(Matrix4x4)))
+    return;
+
+  owner->implUnstream(*this);
   auto data = reinterpret_cast<Matrix4x4*>(owner->dataCpu.data() + rgn.begin);
   if(data[offset] == obj)
     return;
   data[offset] = obj;
-  bitSet(owner->durty, (rgn.begin+offset*sizeof(Matrix4x4))/blockSz);
+  owner->implDurty((rgn.begin+offset*sizeof(Matrix4x4))/blockSz);
   }
 
 void InstanceStorage::Id::set(const void* data, size_t offset, size_t size) {
   if(owner==nullptr)
     return;
 
+  if(owner->implPatchStream(*this, data, offset, size))
+    return;
+
+  owner->implUnstream(*this);
   auto src = reinterpret_cast<const uint8_t*>(data);
   auto dst = (owner->dataCpu.data() + rgn.begin + offset);
 
@@ -90,12 +107,12 @@ void InstanceStorage::Id::set(const void* data, size_t offset, size_t size) {
     for(size_t i=0; i<size; i+=blockSz) {
       const size_t sz = std::min(blockSz, size-i);
       std::memcpy(dst+i, src+i, sz);
-      bitSet(owner->durty, (rgn.begin + offset + i)/blockSz);
+      owner->implDurty((rgn.begin + offset + i)/blockSz);
       }
     } else {
     for(size_t i=0; i<size; ++i) {
       dst[i] = src[i];
-      bitSet(owner->durty, (rgn.begin + offset + i)/blockSz);
+      owner->implDurty((rgn.begin + offset + i)/blockSz);
       }
     }
   }
@@ -106,8 +123,8 @@ InstanceStorage::InstanceStorage() {
   dataCpu.resize(sizeof(Matrix4x4)); // also avoid null-ssbo
   reinterpret_cast<Matrix4x4*>(dataCpu.data())->identity();
 
-  patchCpu.reserve(4*1024*1024);
   patchBlock.reserve(16*1024);
+  stage[stageEpoch%Resources::MaxFramesInFlight].epoch = stageEpoch;
 
   uploadTh = std::thread([this](){ uploadMain(); });
   }
@@ -117,7 +134,7 @@ InstanceStorage::~InstanceStorage() {
     std::unique_lock<std::mutex> lck(sync);
     uploadFId = Resources::MaxFramesInFlight;
   }
-  uploadCnd.notify_one();
+  uploadCnd.notify_all();
   uploadTh.join();
   }
 
@@ -127,18 +144,44 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
   std::atomic_thread_fence(std::memory_order_acquire);
   join();
 
+  auto&          st      = stage[stageEpoch%Resources::MaxFramesInFlight];
+  const uint64_t cursor  = stageCursor.load(std::memory_order_relaxed);
+  const size_t   recCnt  = std::min(size_t(cursor>>32), st.rec.size());
+  const uint32_t chunkSz = 256;
+  st.count = recCnt;
+
   const size_t dataSize = (dataCpu.size() + 0xFFF) & ~size_t(0xFFF);
   if(dataGpu.byteSize()!=dataSize) {
+    // rare: bring streamed regions of all live slices to dataCpu, for full re-upload
+    for(auto& s:stage)
+      implApplyStage(s);
     Resources::recycle(std::move(dataGpu));
     dataGpu = device.ssbo(BufferHeap::Device,Tempest::Uninitialized,dataSize);
     dataGpu.update(dataCpu);
     std::memset(durty.data(), 0, durty.size()*sizeof(uint32_t));
+    durtyAny.store(false, std::memory_order_relaxed);
+    implResetStage();
     return true;
     }
 
+  // streamed regions are already in payload layout - only need to be split into chunks
   patchBlock.clear();
-  size_t payloadSize = 0;
-  for(size_t i = 0; i<blockCnt; ++i) {
+  size_t payloadSize = std::min(size_t(cursor & 0xFFFFFFFF), st.payload.size());
+  for(size_t r=0; r<recCnt; ++r) {
+    Path p = st.rec[r];
+    for(uint32_t size = p.size; size>0;) {
+      p.size = std::min<uint32_t>(size, chunkSz);
+      size  -= p.size;
+      patchBlock.push_back(p);
+
+      p.dst += p.size;
+      p.src += p.size;
+      }
+    }
+
+  const size_t streamCnt = patchBlock.size();
+  const bool   anyDurty  = durtyAny.exchange(false, std::memory_order_relaxed);
+  for(size_t i = 0; anyDurty && i<blockCnt; ++i) {
     if(i%32==0 && durty[i/32]==0) {
       i+=31;
       continue;
@@ -153,7 +196,6 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
       }
 
     uint32_t size    = uint32_t((i-begin)*blockSz);
-    uint32_t chunkSz = 256;
 
     Path p = {};
     p.dst  = uint32_t(begin*blockSz);
@@ -168,35 +210,42 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
       p.src       += p.size;
       }
     }
-  std::memset(durty.data(), 0, durty.size()*sizeof(durty[0]));
+  if(anyDurty)
+    std::memset(durty.data(), 0, durty.size()*sizeof(durty[0]));
 
-  if(patchBlock.size()==0)
+  if(patchBlock.size()==0) {
+    implResetStage();
     return false;
+    }
+
+  if(st.payload.size()<payloadSize)
+    st.payload.resize(payloadSize);
+  for(size_t i=streamCnt; i<patchBlock.size(); ++i) {
+    auto& p = patchBlock[i];
+    std::memcpy(st.payload.data()+p.src, dataCpu.data() + p.dst, p.size);
+    }
 
   const size_t headerSize = patchBlock.size()*sizeof(Path);
-  patchCpu.resize(headerSize + payloadSize);
   for(auto& i:patchBlock) {
     i.src += uint32_t(headerSize);
-    std::memcpy(patchCpu.data()+i.src, dataCpu.data() + i.dst, i.size);
-
     // uint's in shader
     i.src  /= 4;
     i.dst  /= 4;
     i.size /= 4;
     }
-  std::memcpy(patchCpu.data(), patchBlock.data(), headerSize);
 
   auto& path = patchGpu[fId];
   if(path.byteSize() < headerSize + payloadSize) {
     path = device.ssbo(BufferHeap::Upload, Uninitialized, headerSize + payloadSize);
     }
 
+  implResetStage();
   {
     std::unique_lock<std::mutex> lck(sync);
+    patchSize = payloadSize;
     uploadFId = fId;
   }
-  uploadCnd.notify_one();
-  //path.update(patchCpu);
+  uploadCnd.notify_all();
 
   cmd.setFramebuffer({});
   cmd.setBinding(0, dataGpu);
@@ -207,11 +256,8 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
   }
 
 void InstanceStorage::join() {
-  while(true) {
-    std::unique_lock<std::mutex> lck(sync);
-    if(uploadFId<0)
-      break;
-    }
+  std::unique_lock<std::mutex> lck(sync);
+  uploadCnd.wait(lck, [this](){ return uploadFId<0; });
   }
 
 InstanceStorage::Id InstanceStorage::alloc(const size_t size) {
@@ -250,6 +296,7 @@ InstanceStorage::Id InstanceStorage::alloc(const size_t size) {
 
   blockCnt = (dataCpu.size()+blockSz-1)/blockSz;
   durty.resize((blockCnt+32-1)/32, 0);
+  streamed.resize(blockCnt, 0);
   return Id(*this,r);
   }
 
@@ -261,6 +308,8 @@ bool InstanceStorage::realloc(Id& id, const size_t size) {
     return true;
     }
 
+  // streamed matrices have to land in dataCpu, before region is resized or moved
+  implUnstream(id);
   if(size<=id.rgn.size) {
     id.rgn.asize = size;
     return false;
@@ -275,7 +324,7 @@ bool InstanceStorage::realloc(Id& id, const size_t size) {
   auto data = dataCpu.data();
   std::memcpy(data+next.rgn.begin, data+id.rgn.begin, id.rgn.asize);
   for(size_t i=0; i<id.rgn.asize; ++i) {
-    bitSet(durty, (next.rgn.begin + i)/blockSz);
+    implDurty((next.rgn.begin + i)/blockSz);
     }
   id = std::move(next);
   return true;
@@ -303,17 +352,115 @@ void InstanceStorage::free(const Range& r) {
   rgn.insert(at,r);
   }
 
+bool InstanceStorage::implStream(Id& id, const void* data) {
+  if(id.isEmpty())
+    return true;
+  auto& st = stage[stageEpoch%Resources::MaxFramesInFlight];
+  if(id.streamEpoch==stageEpoch) {
+    // same region, written again in same frame
+    std::memcpy(st.payload.data()+id.streamSrc, data, id.rgn.asize);
+    return true;
+    }
+
+  const uint64_t at  = stageCursor.fetch_add((uint64_t(1) << 32) | id.rgn.asize, std::memory_order_relaxed);
+  const size_t   rec = size_t(at >> 32);
+  const size_t   src = size_t(at & 0xFFFFFFFF);
+  if(rec>=st.rec.size())
+    return false;
+  if(src+id.rgn.asize > st.payload.size()) {
+    st.rec[rec] = Path{};
+    return false;
+    }
+
+  std::memcpy(st.payload.data()+src, data, id.rgn.asize);
+  st.rec[rec].dst  = uint32_t(id.rgn.begin);
+  st.rec[rec].src  = uint32_t(src);
+  st.rec[rec].size = uint32_t(id.rgn.asize);
+
+  id.streamEpoch = stageEpoch;
+  id.streamRec   = uint32_t(rec);
+  id.streamSrc   = uint32_t(src);
+  streamed[id.rgn.begin/blockSz] = stageEpoch;
+  return true;
+  }
+
+bool InstanceStorage::implPatchStream(Id& id, const void* data, size_t offset, size_t size) {
+  if(id.streamEpoch!=stageEpoch || streamed[id.rgn.begin/blockSz]!=stageEpoch)
+    return false;
+  // region is streamed in this frame: its record covers whole region, patch payload in place
+  auto& st = stage[stageEpoch%Resources::MaxFramesInFlight];
+  std::memcpy(st.payload.data()+id.streamSrc+offset, data, size);
+  return true;
+  }
+
+void InstanceStorage::implUnstream(Id& id) {
+  if(id.isEmpty() || streamed[id.rgn.begin/blockSz]==0)
+    return;
+  // region is partially overriden, moved or released: move latest streamed copy to dataCpu
+  auto& at = streamed[id.rgn.begin/blockSz];
+  auto& st = stage[at%Resources::MaxFramesInFlight];
+  auto& p  = st.rec[id.streamRec];
+  std::memcpy(dataCpu.data()+p.dst, st.payload.data()+p.src, p.size);
+  if(at==stageEpoch) {
+    // not uploaded yet: fallback to durty-bits
+    p.size = 0;
+    for(size_t i=0; i<id.rgn.asize; i+=blockSz)
+      implDurty((id.rgn.begin+i)/blockSz);
+    }
+  at             = 0;
+  id.streamEpoch = 0;
+  }
+
+void InstanceStorage::implApplyStage(const Stage& st) {
+  // regions, that were not streamed again since: latest copy is about to be lost, keep it in dataCpu
+  for(size_t r=0; r<st.count; ++r) {
+    auto& p = st.rec[r];
+    if(p.size==0 || streamed[p.dst/blockSz]!=st.epoch)
+      continue;
+    std::memcpy(dataCpu.data()+p.dst, st.payload.data()+p.src, p.size);
+    streamed[p.dst/blockSz] = 0;
+    }
+  }
+
+void InstanceStorage::implResetStage() {
+  // size next slice by demand of this frame, so overflowed writes will fit next time
+  const uint64_t cursor = stageCursor.load(std::memory_order_relaxed);
+  const size_t   recCnt = size_t(cursor >> 32);
+  const size_t   bytes  = size_t(cursor & 0xFFFFFFFF);
+
+  ++stageEpoch;
+  auto& st = stage[stageEpoch%Resources::MaxFramesInFlight];
+  implApplyStage(st);
+  st.epoch = stageEpoch;
+  st.count = 0;
+  if(st.rec.size()<recCnt)
+    st.rec.resize(nextPot(uint32_t(recCnt)));
+  if(st.payload.size()<bytes)
+    st.payload.resize(nextPot(uint32_t(bytes)));
+  stageCursor.store(0, std::memory_order_relaxed);
+  }
+
+void InstanceStorage::implDurty(size_t block) {
+  bitSet(durty, block);
+  if(!durtyAny.load(std::memory_order_relaxed))
+    durtyAny.store(true, std::memory_order_relaxed);
+  }
+
 void InstanceStorage::uploadMain() {
   Workers::setThreadName("InstanceStorage upload");
   while(true) {
     std::unique_lock<std::mutex> lck(sync);
-    uploadCnd.wait(lck);
+    uploadCnd.wait(lck, [this](){ return uploadFId>=0; });
     if(uploadFId==Resources::MaxFramesInFlight)
       break;
-    if(uploadFId<0)
-      continue;
 
-    patchGpu[uploadFId].update(patchCpu);
+    auto&        st         = stage[(stageEpoch-1)%Resources::MaxFramesInFlight];
+    auto&        path       = patchGpu[uploadFId];
+    const size_t headerSize = patchBlock.size()*sizeof(Path);
+    path.update(patchBlock.data(), 0,          headerSize);
+    path.update(st.payload.data(), headerSize, patchSize);
     uploadFId = -1;
+    lck.unlock();
+    uploadCnd.notify_all();
     }
   }
@@ -5,6 +5,7 @@
 #include <Tempest/UniformBuffer>
 
 #include <condition_variable>
+#include <atomic>
 #include <vector>
 #include <thread>
 
@@ -43,6 +44,10 @@ class InstanceStorage {
       private:
         InstanceStorage* owner = nullptr;
         Range            rgn;
+        // slot in staging slice, valid while streamEpoch matches owner
+        uint64_t         streamEpoch = 0;
+        uint32_t         streamRec   = 0;
+        uint32_t         streamSrc   = 0;
       friend class InstanceStorage;
       };
 
@@ -56,22 +61,46 @@ class InstanceStorage {
     void join();
 
   private:
-    void free(const Range& r);
-    void uploadMain();
-
     struct Path {
       uint32_t dst;
       uint32_t src;
       uint32_t size;
       };
 
+    // Per-frame staging slice: whole-region writes (skinning matrices) are placed here
+    // by animation workers directly, in patch-payload layout. dataCpu of such region stays stale,
+    // until region stops being streamed, see implApplyStage.
+    // Anything, that didn't fit, goes via dataCpu and durty-bits
+    struct Stage {
+      std::vector<Path>    rec;
+      std::vector<uint8_t> payload;
+      uint64_t             epoch = 0;
+      size_t               count = 0;
+      };
+
+    void free(const Range& r);
+    void uploadMain();
+
+    bool implStream(Id& id, const void* data);
+    bool implPatchStream(Id& id, const void* data, size_t offset, size_t size);
+    void implUnstream(Id& id);
+    void implApplyStage(const Stage& st);
+    void implResetStage();
+    void implDurty(size_t block);
+
     std::vector<Range>      rgn;
     std::vector<uint32_t>   durty;
+    std::atomic_bool        durtyAny{false};
+    std::vector<uint64_t>   streamed; // per block: epoch of latest streamed copy, 0 if dataCpu is up to date
     size_t                  blockCnt = 0;
 
     Tempest::StorageBuffer  patchGpu[Resources::MaxFramesInFlight];
-    std::vector<uint8_t>    patchCpu;
     std::vector<Path>       patchBlock;
+    size_t                  patchSize = 0;
+
+    Stage                   stage[Resources::MaxFramesInFlight];
+    std::atomic<uint64_t>   stageCursor{0}; // records count in high 32 bits, payload bytes in low
+    uint64_t                stageEpoch = 1;
 
     Tempest::StorageBuffer  dataGpu;
     std::vector<uint8_t>    dataCpu;
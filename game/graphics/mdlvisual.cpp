@@ -526,6 +526,10 @@ bool MdlVisual::updateAnimation(Npc* npc, Interactive* mobsi, World& world, uint
   return changed;
   }
 
+void MdlVisual::setAnimLod(uint64_t interval, bool skipMinor) {
+  skInst->setAnimLod(interval,skipMinor);
+  }
+
 void MdlVisual::processLayers(World& world) {
   Pose&    pose      = *skInst;
   uint64_t tickCount = world.tickCount();
@@ -556,7 +560,7 @@ Vec3 MdlVisual::mapWeaponBone() const {
   }
 
 Vec3 MdlVisual::mapHeadBone() const {
-  if(skeleton->BIP01_HEAD==size_t(-1))
+  if(skeleton==nullptr || skeleton->BIP01_HEAD==size_t(-1))
     return {pos.at(3,0), pos.at(3,1)+180, pos.at(3,2)};
   return mapBone(skeleton->BIP01_HEAD);
   }
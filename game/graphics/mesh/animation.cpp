@@ -91,24 +91,60 @@ Animation::Animation(zenkit::ModelScript& p, std::string_view name, const bool i
   }
 
 const Animation::Sequence* Animation::sequence(std::string_view name) const {
-  if(sqHot!=nullptr && sqHot->name==name)
-    return sqHot;
-  auto it = std::lower_bound(sequences.begin(),sequences.end(),name,[](const Sequence& s,std::string_view n){
-    return s.name<n;
-    });
+  return findIndex(nameIndex,name,[](const Sequence& s) -> std::string_view { return s.name; });
+  }
 
-  if(it!=sequences.end() && it->name==name) {
-    sqHot = &(*it);
-    return &(*it);
+const Animation::Sequence *Animation::sequenceAsc(std::string_view name) const {
+  return findIndex(ascIndex,name,[](const Sequence& s) -> std::string_view { return s.askName; });
+  }
+
+uint32_t Animation::hash(std::string_view name) {
+  // FNV-1a
+  uint32_t h = 2166136261u;
+  for(auto c:name) {
+    h ^= uint8_t(c);
+    h *= 16777619u;
     }
-  return nullptr;
+  return h;
   }
 
-const Animation::Sequence *Animation::sequenceAsc(std::string_view name) const {
-  for(auto& i:sequences)
-    if(i.askName==name)
-      return &i;
-  return nullptr;
+template<class Key>
+void Animation::buildIndex(std::vector<IndexEntry>& index, Key key) {
+  size_t size = 16;
+  while(size<sequences.size()*2)
+    size *= 2;
+  index.assign(size,IndexEntry());
+
+  const size_t mask = size-1;
+  for(size_t i=0; i<sequences.size(); ++i) {
+    const std::string_view k = key(sequences[i]);
+    const uint32_t         h = hash(k);
+    for(size_t at=h&mask; ; at=(at+1)&mask) {
+      auto& e = index[at];
+      if(e.id==uint32_t(-1)) {
+        e.hash = h;
+        e.id   = uint32_t(i);
+        break;
+        }
+      if(e.hash==h && key(sequences[e.id])==k)
+        break; // duplicate name: first one wins, same as linear search
+      }
+    }
+  }
+
+template<class Key>
+const Animation::Sequence* Animation::findIndex(const std::vector<IndexEntry>& index, std::string_view name, Key key) const {
+  if(index.empty())
+    return nullptr;
+  const size_t   mask = index.size()-1;
+  const uint32_t h    = hash(name);
+  for(size_t at=h&mask; ; at=(at+1)&mask) {
+    auto& e = index[at];
+    if(e.id==uint32_t(-1))
+      return nullptr;
+    if(e.hash==h && key(sequences[e.id])==name)
+      return &sequences[e.id];
+    }
   }
 
 void Animation::debug() const {
@@ -168,6 +204,8 @@ void Animation::setupIndex() {
   std::sort(sequences.begin(),sequences.end(),[](const Sequence& a,const Sequence& b){
     return a.name<b.name;
     });
+  buildIndex(nameIndex,[](const Sequence& s) -> std::string_view { return s.name;    });
+  buildIndex(ascIndex, [](const Sequence& s) -> std::string_view { return s.askName; });
 
   for(auto& s:sequences) {
     if(s.comb.size()==0)
@@ -231,9 +269,9 @@ Animation::Sequence::Sequence(const zenkit::MdsAnimation& hdr, std::string_view
   data->fpsRate   = p.fps;
   data->numFrames = p.frame_count;
   data->nodeIndex = p.node_indices;
-  data->samples   = p.samples;
+  data->samples.pack(p.samples,p.node_indices.size());
 
-  data->setupMoveTr();
+  data->setupMoveTr(p.samples);
   }
 
 bool Animation::Sequence::isFinished(uint64_t now, uint64_t sTime, uint16_t comboLen) const {
@@ -572,7 +610,7 @@ void Animation::Sequence::schemeName(char scheme[64]) const {
     }
   }
 
-void Animation::AnimData::setupMoveTr() {
+void Animation::AnimData::setupMoveTr(const std::vector<zenkit::AnimationSample>& samples) {
   size_t sz = nodeIndex.size();
   if(sz==0)
     return;
@@ -6,6 +6,8 @@
 #include <Tempest/Vec>
 #include <memory>
 
+#include "animsamples.h"
+
 class Npc;
 class MdlVisual;
 class Interactive;
@@ -47,7 +49,7 @@ class Animation final {
       Tempest::Vec3                               translate={};
       Tempest::Vec3                               moveTr={};
 
-      std::vector<zenkit::AnimationSample>        samples;
+      AnimSamples                                 samples;
       std::vector<uint32_t>                       nodeIndex;
       std::vector<Tempest::Vec3>                  tr;
       bool                                        hasMoveTr=false;
@@ -69,7 +71,7 @@ class Animation final {
       std::vector<uint64_t>                       defParFrame;
       std::vector<uint64_t>                       defWindow;
 
-      void                                        setupMoveTr();
+      void                                        setupMoveTr(const std::vector<zenkit::AnimationSample>& samples);
       void                                        setupEvents(float fpsRate);
       };
 
@@ -130,11 +132,24 @@ class Animation final {
     std::string_view   defaultMesh() const;
 
   private:
+    // open addressing hash table over sequences, built once in setupIndex
+    struct IndexEntry {
+      uint32_t hash = 0;
+      uint32_t id   = uint32_t(-1);
+      };
+
     Sequence&          loadMAN(const zenkit::MdsAnimation& hdr, std::string_view name);
     void               setupIndex();
 
-    mutable const Sequence*                  sqHot = nullptr;
+    template<class Key>
+    void               buildIndex(std::vector<IndexEntry>& index, Key key);
+    template<class Key>
+    const Sequence*    findIndex(const std::vector<IndexEntry>& index, std::string_view name, Key key) const;
+    static uint32_t    hash(std::string_view name);
+
     std::vector<Sequence>                    sequences;
+    std::vector<IndexEntry>                  nameIndex;
+    std::vector<IndexEntry>                  ascIndex;
     std::vector<zenkit::MdsAnimationAlias>   ref;
     std::vector<std::string>                 mesh;
     zenkit::MdsSkeleton                      meshDef;
@@ -101,13 +101,38 @@ void AnimationSolver::update(uint64_t tickCount) {
   }
 
 const Animation::Sequence* AnimationSolver::solveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
-  if(0<a && a<=AnimationSolver::CacheLast && int(st)<2 && int(wlkMode)<2) {
-    auto& ptr = cache[a-1][int(st)][int(wlkMode)];
-    if(ptr==nullptr)
-      ptr = implSolveAnim(a,st,wlkMode,pose);
-    return ptr;
+  if(!isCacheable(a,wlkMode))
+    return implSolveAnim(a,st,wlkMode,pose);
+
+  const uint32_t key = uint32_t(a) | (uint32_t(st)<<16) | (uint32_t(wlkMode)<<24);
+  auto it = cache.find(key);
+  if(it!=cache.end())
+    return it->second;
+  auto ret = implSolveAnim(a,st,wlkMode,pose);
+  cache[key] = ret;
+  return ret;
+  }
+
+bool AnimationSolver::isCacheable(Anim a, WalkBit wlkMode) {
+  // must match implSolveAnim: these depend on pose or random
+  switch(a) {
+    case Move:
+      return !bool(wlkMode & WalkBit::WM_Dive);
+    case Attack:
+    case AttackL:
+    case AttackR:
+    case AttackBlock:
+    case AttackFinish:
+    case AimBow:
+    case JumpHang:
+    case Fallen:
+    case FallDeep:
+    case DeadA:
+    case DeadB:
+      return false;
+    default:
+      return true;
     }
-  return implSolveAnim(a,st,wlkMode,pose);
   }
 
 const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
@@ -493,7 +518,7 @@ const Animation::Sequence *AnimationSolver::solveDead(std::string_view format1,
   }
 
 void AnimationSolver::invalidateCache() {
-  std::memset(cache,0,sizeof(cache));
+  cache.clear();
   }
 
 const Animation::Sequence* AnimationSolver::solveNext(const Animation::Sequence& sq) const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Tempest/Matrix4x4>
+#include <unordered_map>
 #include <vector>
 
 #include "game/constants.h"
@@ -21,7 +22,6 @@ class AnimationSolver final {
       NoAnim,
       Idle,
       Move,
-      CacheLast = Move,
 
       MoveBack,
       MoveL,
@@ -109,10 +109,12 @@ class AnimationSolver final {
     const Animation::Sequence*     solveDead   (std::string_view format1, std::string_view format2) const;
 
     const Animation::Sequence*     implSolveAnim(Anim a, WeaponState st, WalkBit wlk, const Pose &pose) const;
+    static bool                    isCacheable  (Anim a, WalkBit wlk);
     void                           invalidateCache();
 
     const Skeleton*                baseSk=nullptr;
     std::vector<Overlay>           overlay;
 
-    mutable const Animation::Sequence* cache [CacheLast][2][2] = {};
+    // (anim, weapon, walk-mode) -> sequence, for animations that don't depend on pose; nullptr results are cached too
+    mutable std::unordered_map<uint32_t,const Animation::Sequence*> cache;
   };
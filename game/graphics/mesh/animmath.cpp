@@ -1,6 +1,18 @@
 #include "animmath.h"
 
+#include <Tempest/Log>
+
+#include <algorithm>
 #include <cmath>
+#include <random>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define ANIMMATH_SSE
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ANIMMATH_NEON
+#include <arm_neon.h>
+#endif
 
 static float mix(float x,float y,float a){
   return x+(y-x)*a;
@@ -77,3 +89,290 @@ Tempest::Matrix4x4 mkMatrix(const zenkit::AnimationSample& s) {
   return mkMatrix(s.rotation.x,s.rotation.y,s.rotation.z,s.rotation.w,
                   s.position.x,s.position.y,s.position.z);
   }
+
+namespace {
+
+// single lane, also used for tails of batches
+struct F1 {
+  static constexpr size_t Width = 1;
+  float v;
+
+  static F1 load (const float* p) { return {*p}; }
+  static F1 splat(float f)        { return {f};  }
+  void      store(float* p) const { *p = v; }
+  };
+
+inline F1 operator + (F1 a, F1 b) { return {a.v+b.v}; }
+inline F1 operator - (F1 a, F1 b) { return {a.v-b.v}; }
+inline F1 operator * (F1 a, F1 b) { return {a.v*b.v}; }
+inline F1 operator / (F1 a, F1 b) { return {a.v/b.v}; }
+inline F1 sqrt    (F1 a)          { return {std::sqrt(a.v)}; }
+inline F1 signMask(F1 a)          { return {std::signbit(a.v) ? -0.f : 0.f}; }
+inline F1 flipSign(F1 a, F1 mask) { return {std::signbit(mask.v) ? -a.v : a.v}; }
+
+#if defined(ANIMMATH_SSE)
+struct F4 {
+  static constexpr size_t Width = 4;
+  __m128 v;
+
+  static F4 load (const float* p) { return {_mm_loadu_ps(p)}; }
+  static F4 splat(float f)        { return {_mm_set1_ps(f)}; }
+  void      store(float* p) const { _mm_storeu_ps(p,v); }
+  };
+
+inline F4 operator + (F4 a, F4 b) { return {_mm_add_ps(a.v,b.v)}; }
+inline F4 operator - (F4 a, F4 b) { return {_mm_sub_ps(a.v,b.v)}; }
+inline F4 operator * (F4 a, F4 b) { return {_mm_mul_ps(a.v,b.v)}; }
+inline F4 operator / (F4 a, F4 b) { return {_mm_div_ps(a.v,b.v)}; }
+inline F4 sqrt    (F4 a)          { return {_mm_sqrt_ps(a.v)}; }
+inline F4 signMask(F4 a)          { return {_mm_and_ps(a.v,_mm_set1_ps(-0.f))}; }
+inline F4 flipSign(F4 a, F4 mask) { return {_mm_xor_ps(a.v,mask.v)}; }
+#elif defined(ANIMMATH_NEON)
+struct F4 {
+  static constexpr size_t Width = 4;
+  float32x4_t v;
+
+  static F4 load (const float* p) { return {vld1q_f32(p)}; }
+  static F4 splat(float f)        { return {vdupq_n_f32(f)}; }
+  void      store(float* p) const { vst1q_f32(p,v); }
+  };
+
+inline F4 operator + (F4 a, F4 b) { return {vaddq_f32(a.v,b.v)}; }
+inline F4 operator - (F4 a, F4 b) { return {vsubq_f32(a.v,b.v)}; }
+inline F4 operator * (F4 a, F4 b) { return {vmulq_f32(a.v,b.v)}; }
+inline F4 operator / (F4 a, F4 b) { return {vdivq_f32(a.v,b.v)}; }
+inline F4 sqrt    (F4 a)          { return {vsqrtq_f32(a.v)}; }
+inline F4 signMask(F4 a) {
+  return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v),vdupq_n_u32(0x80000000u)))};
+  }
+inline F4 flipSign(F4 a, F4 mask) {
+  return {vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v),vreinterpretq_u32_f32(mask.v)))};
+  }
+#endif
+
+template<class V>
+size_t mixKernel(const zenkit::AnimationSample* x, const zenkit::AnimationSample* y, float a,
+                 zenkit::AnimationSample* out, size_t count) {
+  constexpr size_t W = V::Width;
+
+  // corrected nlerp: https://zeux.io/2015/07/23/approximating-slerp/
+  // polynomials depend on |cos(theta)| only, 'a' is same for every lane
+  const float h  = a-0.5f;
+  const V     t  = V::splat(a);
+  const V     th = V::splat(a*h*(a-1.f));
+  const V     hh = V::splat(h*h);
+  const V     one = V::splat(1.f);
+
+  size_t i = 0;
+  for(; i+W<=count; i+=W) {
+    alignas(16) float src[14][W];
+    for(size_t l=0; l<W; ++l) {
+      auto& sx = x[i+l];
+      auto& sy = y[i+l];
+      src[ 0][l] = sx.rotation.x;  src[ 1][l] = sx.rotation.y;  src[ 2][l] = sx.rotation.z;  src[ 3][l] = sx.rotation.w;
+      src[ 4][l] = sy.rotation.x;  src[ 5][l] = sy.rotation.y;  src[ 6][l] = sy.rotation.z;  src[ 7][l] = sy.rotation.w;
+      src[ 8][l] = sx.position.x;  src[ 9][l] = sx.position.y;  src[10][l] = sx.position.z;
+      src[11][l] = sy.position.x;  src[12][l] = sy.position.y;  src[13][l] = sy.position.z;
+      }
+
+    const V ax = V::load(src[0]), ay = V::load(src[1]), az = V::load(src[2]), aw = V::load(src[3]);
+    const V bx = V::load(src[4]), by = V::load(src[5]), bz = V::load(src[6]), bw = V::load(src[7]);
+
+    const V cosT = ax*bx + ay*by + az*bz + aw*bw;
+    const V sign = signMask(cosT);
+    const V d    = flipSign(cosT,sign);
+
+    const V A    = V::splat(1.0904f)   + d*(V::splat(-3.2452f) + d*(V::splat(3.55645f) - d*V::splat(1.43519f)));
+    const V B    = V::splat(0.848013f) + d*(V::splat(-1.06021f) + d*V::splat(0.215638f));
+    const V k    = A*hh + B;
+    const V ot   = t + th*k;
+    const V lt   = one - ot;
+    const V rt   = flipSign(ot,sign);
+
+    const V qx   = ax*lt + bx*rt;
+    const V qy   = ay*lt + by*rt;
+    const V qz   = az*lt + bz*rt;
+    const V qw   = aw*lt + bw*rt;
+    const V len  = sqrt(qx*qx + qy*qy + qz*qz + qw*qw);
+
+    alignas(16) float dst[7][W];
+    (qx/len).store(dst[0]);
+    (qy/len).store(dst[1]);
+    (qz/len).store(dst[2]);
+    (qw/len).store(dst[3]);
+
+    const V px = V::load(src[ 8]), py = V::load(src[ 9]), pz = V::load(src[10]);
+    (px + (V::load(src[11])-px)*t).store(dst[4]);
+    (py + (V::load(src[12])-py)*t).store(dst[5]);
+    (pz + (V::load(src[13])-pz)*t).store(dst[6]);
+
+    for(size_t l=0; l<W; ++l) {
+      auto& r = out[i+l];
+      r.rotation   = zenkit::Quat(dst[3][l],dst[0][l],dst[1][l],dst[2][l]);
+      r.position.x = dst[4][l];
+      r.position.y = dst[5][l];
+      r.position.z = dst[6][l];
+      }
+    }
+  return i;
+  }
+
+template<class V>
+size_t mkMatrixKernel(const zenkit::AnimationSample* s, Tempest::Matrix4x4* out, size_t count) {
+  constexpr size_t W = V::Width;
+  const V two = V::splat(2.f);
+
+  size_t i = 0;
+  for(; i+W<=count; i+=W) {
+    alignas(16) float src[4][W];
+    for(size_t l=0; l<W; ++l) {
+      auto& r = s[i+l].rotation;
+      src[0][l] = r.x;  src[1][l] = r.y;  src[2][l] = r.z;  src[3][l] = r.w;
+      }
+    const V x = V::load(src[0]), y = V::load(src[1]), z = V::load(src[2]), w = V::load(src[3]);
+    const V xx = x*x, yy = y*y, zz = z*z, ww = w*w;
+
+    alignas(16) float m[9][W];
+    (ww + xx - yy - zz).store(m[0]);
+    (two*(x*y - w*z)  ).store(m[1]);
+    (two*(x*z + w*y)  ).store(m[2]);
+    (two*(x*y + w*z)  ).store(m[3]);
+    (ww - xx + yy - zz).store(m[4]);
+    (two*(y*z - w*x)  ).store(m[5]);
+    (two*(x*z - w*y)  ).store(m[6]);
+    (two*(y*z + w*x)  ).store(m[7]);
+    (ww - xx - yy + zz).store(m[8]);
+
+    for(size_t l=0; l<W; ++l) {
+      auto& p = s[i+l].position;
+      float r[4][4] = {
+        {m[0][l], m[1][l], m[2][l], 0},
+        {m[3][l], m[4][l], m[5][l], 0},
+        {m[6][l], m[7][l], m[8][l], 0},
+        {p.x,     p.y,     p.z,     1},
+        };
+      out[i+l] = Tempest::Matrix4x4(reinterpret_cast<float*>(r));
+      }
+    }
+  return i;
+  }
+
+}
+
+void mix(const zenkit::AnimationSample* x, const zenkit::AnimationSample* y, float a,
+         zenkit::AnimationSample* out, size_t count) {
+  size_t i = 0;
+#if defined(ANIMMATH_SSE) || defined(ANIMMATH_NEON)
+  i = mixKernel<F4>(x,y,a,out,count);
+#endif
+  mixKernel<F1>(x+i,y+i,a,out+i,count-i);
+  }
+
+void mkMatrix(const zenkit::AnimationSample* s, Tempest::Matrix4x4* out, size_t count) {
+  size_t i = 0;
+#if defined(ANIMMATH_SSE) || defined(ANIMMATH_NEON)
+  i = mkMatrixKernel<F4>(s,out,count);
+#endif
+  mkMatrixKernel<F1>(s+i,out+i,count-i);
+  }
+
+void mulMatrix(const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b, Tempest::Matrix4x4& out) {
+#if defined(ANIMMATH_SSE) || defined(ANIMMATH_NEON)
+  // column-major: column 'i' of result is combination of columns of 'a'
+  // 'out' may alias 'a' or 'b': 'a' is loaded upfront, and each column of 'b' is read before it's written
+  const float* ma = reinterpret_cast<const float*>(&a);
+  const float* mb = reinterpret_cast<const float*>(&b);
+  float*       mr = reinterpret_cast<float*>(&out);
+
+  const F4 a0 = F4::load(ma), a1 = F4::load(ma+4), a2 = F4::load(ma+8), a3 = F4::load(ma+12);
+  for(int i=0; i<4; ++i) {
+    const float* c = mb+i*4;
+    (a0*F4::splat(c[0]) + a1*F4::splat(c[1]) + a2*F4::splat(c[2]) + a3*F4::splat(c[3])).store(mr+i*4);
+    }
+#else
+  out = a*b;
+#endif
+  }
+
+bool animMathSelfCheck() {
+  // batched kernels against reference path: slerp, scalar mkMatrix and Matrix4x4::operator *
+  // count is not a multiple of four - both SIMD lanes and scalar tail are covered
+  static const size_t count = 23;
+  std::minstd_rand                      rng(0x5eed);
+  std::uniform_real_distribution<float> unit(-1.f,1.f);
+
+  auto mkSample = [&]() {
+    zenkit::AnimationSample s = {};
+    float x = unit(rng), y = unit(rng), z = unit(rng), w = unit(rng);
+    float l = std::sqrt(x*x+y*y+z*z+w*w);
+    if(l<1e-3f) {
+      x = 0; y = 0; z = 0; w = l = 1;
+      }
+    s.rotation   = zenkit::Quat(w/l,x/l,y/l,z/l);
+    s.position.x = unit(rng)*100.f;
+    s.position.y = unit(rng)*100.f;
+    s.position.z = unit(rng)*100.f;
+    return s;
+    };
+
+  zenkit::AnimationSample x[count], y[count], r[count];
+  for(size_t i=0; i<count; ++i) {
+    x[i] = mkSample();
+    y[i] = mkSample();
+    }
+  // same rotation; same rotation with flipped sign (shortest path); nearly same rotation
+  y[0].rotation = x[0].rotation;
+  y[1].rotation = zenkit::Quat(-x[1].rotation.w,-x[1].rotation.x,-x[1].rotation.y,-x[1].rotation.z);
+  const auto& q2 = x[2].rotation;
+  const float l2 = std::sqrt(q2.w*q2.w + (q2.x+1e-4f)*(q2.x+1e-4f) + q2.y*q2.y + q2.z*q2.z);
+  y[2].rotation = zenkit::Quat(q2.w/l2,(q2.x+1e-4f)/l2,q2.y/l2,q2.z/l2);
+
+  bool ok = true;
+  for(float a : {0.f, 0.125f, 0.25f, 0.5f, 0.75f, 0.9f, 1.f}) {
+    mix(x,y,a,r,count);
+    for(size_t i=0; i<count; ++i) {
+      auto  ref = mix(x[i],y[i],a);
+      auto& q   = r[i].rotation;
+      float dot = std::abs(q.x*ref.rotation.x + q.y*ref.rotation.y + q.z*ref.rotation.z + q.w*ref.rotation.w);
+      float dp  = std::max({std::abs(r[i].position.x-ref.position.x),
+                            std::abs(r[i].position.y-ref.position.y),
+                            std::abs(r[i].position.z-ref.position.z)});
+      if(1.f-dot>1e-5f || dp>1e-3f) {
+        Tempest::Log::e("animmath: batched mix mismatch, bone: ",i," a: ",a," 1-dot: ",1.f-dot," pos: ",dp);
+        ok = false;
+        }
+      }
+    }
+
+  Tempest::Matrix4x4 m[count];
+  mkMatrix(x,m,count);
+  for(size_t i=0; i<count; ++i) {
+    auto         ref = mkMatrix(x[i]);
+    const float* a   = reinterpret_cast<const float*>(&m[i]);
+    const float* b   = reinterpret_cast<const float*>(&ref);
+    for(int e=0; e<16; ++e) {
+      if(std::abs(a[e]-b[e])>1e-5f) {
+        Tempest::Log::e("animmath: batched mkMatrix mismatch, bone: ",i," element: ",e);
+        ok = false;
+        break;
+        }
+      }
+    }
+
+  for(size_t i=0; i+1<count; ++i) {
+    auto ref = m[i]*m[i+1];
+    auto mat = m[i];
+    // output aliases input - allowed by mulMatrix
+    mulMatrix(mat,m[i+1],mat);
+    const float* a = reinterpret_cast<const float*>(&mat);
+    const float* b = reinterpret_cast<const float*>(&ref);
+    for(int e=0; e<16; ++e) {
+      if(std::abs(a[e]-b[e])>1e-4f*(1.f+std::abs(b[e]))) {
+        Tempest::Log::e("animmath: mulMatrix mismatch, matrix: ",i," element: ",e);
+        ok = false;
+        break;
+        }
+      }
+    }
+  return ok;
+  }
@@ -5,6 +5,19 @@
 
 #include <zenkit/ModelAnimation.hh>
 
+#include <cstddef>
+
 zenkit::AnimationSample mix(const zenkit::AnimationSample& x, const zenkit::AnimationSample& y, float a);
 zenkit::Quat            slerp(const zenkit::Quat& x, const zenkit::Quat& y, float a);
 Tempest::Matrix4x4      mkMatrix(const zenkit::AnimationSample& s);
+
+// Batched variants for whole skeleton. Bones are processed in groups of four with SSE/NEON, if available.
+// Rotations are interpolated with corrected nlerp (fast slerp approximation), same formula for every lane
+void                    mix(const zenkit::AnimationSample* x, const zenkit::AnimationSample* y, float a,
+                            zenkit::AnimationSample* out, size_t count);
+void                    mkMatrix(const zenkit::AnimationSample* s, Tempest::Matrix4x4* out, size_t count);
+// out = a*b
+void                    mulMatrix(const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b, Tempest::Matrix4x4& out);
+
+// compares batched variants against slerp/mkMatrix/operator *; logs mismatches. Debug builds run it on startup
+bool                    animMathSelfCheck();
@@ -0,0 +1,202 @@
+#include "animsamples.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+
+static std::atomic<uint64_t> statRawBytes    {0};
+static std::atomic<uint64_t> statPackedBytes {0};
+
+static const float qRange = 0.70710678f; // smallest-three components are within [-1/sqrt(2), 1/sqrt(2)]
+static const float qMax   = 32767.f;     // 15 bit
+
+static uint16_t quantize(float v) {
+  float x = (v/qRange)*0.5f+0.5f;
+  x = std::clamp(x,0.f,1.f);
+  return uint16_t(std::lround(x*qMax));
+  }
+
+static float dequantize(uint64_t q) {
+  return (float(q)/qMax*2.f-1.f)*qRange;
+  }
+
+static void packQuat(const zenkit::Quat& q, uint16_t* dst) {
+  const float c[4] = {q.x, q.y, q.z, q.w};
+  int id = 0;
+  for(int i=1; i<4; ++i)
+    if(std::abs(c[i])>std::abs(c[id]))
+      id = i;
+
+  // q and -q are same rotation: make largest component positive, to reconstruct it from other three
+  const float sign = c[id]<0 ? -1.f : 1.f;
+  uint64_t    bits = uint64_t(id);
+  for(int i=0; i<4; ++i) {
+    if(i==id)
+      continue;
+    bits = (bits<<15) | quantize(c[i]*sign);
+    }
+  dst[0] = uint16_t(bits);
+  dst[1] = uint16_t(bits>>16);
+  dst[2] = uint16_t(bits>>32);
+  }
+
+static zenkit::Quat unpackQuat(const uint16_t* src) {
+  const uint64_t bits = uint64_t(src[0]) | (uint64_t(src[1])<<16) | (uint64_t(src[2])<<32);
+  const int      id   = int(bits>>45);
+
+  float c[4] = {};
+  float sum  = 0;
+  for(int i=3, shift=0; i>=0; --i) {
+    if(i==id)
+      continue;
+    c[i]   = dequantize((bits>>shift) & 0x7FFF);
+    sum   += c[i]*c[i];
+    shift += 15;
+    }
+  c[id] = std::sqrt(std::max(0.f,1.f-sum));
+  return zenkit::Quat(c[3],c[0],c[1],c[2]);
+  }
+
+static bool isSameRot(const zenkit::AnimationSample& a, const zenkit::AnimationSample& b) {
+  return a.rotation.x==b.rotation.x && a.rotation.y==b.rotation.y && a.rotation.z==b.rotation.z && a.rotation.w==b.rotation.w;
+  }
+
+static bool isSamePos(const zenkit::AnimationSample& a, const zenkit::AnimationSample& b) {
+  return a.position.x==b.position.x && a.position.y==b.position.y && a.position.z==b.position.z;
+  }
+
+AnimSamples::AnimSamples(AnimSamples&& other) {
+  *this = std::move(other);
+  }
+
+AnimSamples::~AnimSamples() {
+  release();
+  }
+
+AnimSamples& AnimSamples::operator = (AnimSamples&& other) {
+  if(this==&other)
+    return *this;
+  release();
+  tracks    = std::move(other.tracks);
+  posRange  = std::move(other.posRange);
+  rot       = std::move(other.rot);
+  pos       = std::move(other.pos);
+  rotCount  = other.rotCount;
+  posCount  = other.posCount;
+  numFrames = other.numFrames;
+  rawBytes  = other.rawBytes;
+  // stat is transferred as well
+  other.tracks.clear();
+  other.posRange.clear();
+  other.rot.clear();
+  other.pos.clear();
+  other.rawBytes  = 0;
+  other.numFrames = 0;
+  return *this;
+  }
+
+void AnimSamples::release() {
+  statRawBytes    -= rawBytes;
+  statPackedBytes -= byteSize();
+  tracks.clear();
+  posRange.clear();
+  rot.clear();
+  pos.clear();
+  rotCount  = 0;
+  posCount  = 0;
+  numFrames = 0;
+  rawBytes  = 0;
+  }
+
+size_t AnimSamples::byteSize() const {
+  return tracks.size()*sizeof(Track) + posRange.size()*sizeof(PosRange) + (rot.size()+pos.size())*sizeof(uint16_t);
+  }
+
+void AnimSamples::pack(const std::vector<zenkit::AnimationSample>& samples, size_t numTracks) {
+  release();
+  if(numTracks==0 || samples.size()%numTracks!=0)
+    return;
+
+  numFrames = samples.size()/numTracks;
+  tracks.resize(numTracks);
+  for(size_t t=0; t<numTracks; ++t) {
+    auto& tr = tracks[t];
+    tr.value = samples[t];
+
+    bool constRot = true, constPos = true;
+    for(size_t f=1; f<numFrames; ++f) {
+      auto& s = samples[f*numTracks+t];
+      constRot &= isSameRot(s,tr.value);
+      constPos &= isSamePos(s,tr.value);
+      }
+
+    if(!constRot)
+      tr.rot = rotCount++;
+    if(!constPos) {
+      PosRange r;
+      for(int i=0; i<3; ++i) {
+        float mn = tr.value.position[i], mx = mn;
+        for(size_t f=1; f<numFrames; ++f) {
+          const float v = samples[f*numTracks+t].position[i];
+          mn = std::min(mn,v);
+          mx = std::max(mx,v);
+          }
+        r.min  [i] = mn;
+        r.scale[i] = (mx-mn)/65535.f;
+        }
+      tr.pos = posCount++;
+      posRange.push_back(r);
+      }
+    }
+
+  rot.resize(numFrames*rotCount*3);
+  pos.resize(numFrames*posCount*3);
+  for(size_t f=0; f<numFrames; ++f) {
+    for(size_t t=0; t<numTracks; ++t) {
+      auto& tr = tracks[t];
+      auto& s  = samples[f*numTracks+t];
+      if(tr.rot!=Const)
+        packQuat(s.rotation,&rot[(f*rotCount+tr.rot)*3]);
+      if(tr.pos!=Const) {
+        auto&     r   = posRange[tr.pos];
+        uint16_t* dst = &pos[(f*posCount+tr.pos)*3];
+        for(int i=0; i<3; ++i) {
+          const float v = r.scale[i]>0 ? (s.position[i]-r.min[i])/r.scale[i] : 0.f;
+          dst[i] = uint16_t(std::lround(std::clamp(v,0.f,65535.f)));
+          }
+        }
+      }
+    }
+
+  rawBytes         = samples.size()*sizeof(zenkit::AnimationSample);
+  statRawBytes    += rawBytes;
+  statPackedBytes += byteSize();
+  }
+
+void AnimSamples::decode(size_t frame, size_t begin, size_t count, zenkit::AnimationSample* out) const {
+  assert(frame<numFrames && begin+count<=tracks.size());
+  const uint16_t* fRot = rot.data() + frame*rotCount*3;
+  const uint16_t* fPos = pos.data() + frame*posCount*3;
+  for(size_t i=0; i<count; ++i) {
+    auto& tr = tracks[begin+i];
+    auto& o  = out[i];
+    o = tr.value;
+    if(tr.rot!=Const)
+      o.rotation = unpackQuat(fRot + tr.rot*3);
+    if(tr.pos!=Const) {
+      auto&           r   = posRange[tr.pos];
+      const uint16_t* src = fPos + tr.pos*3;
+      o.position.x = r.min[0] + float(src[0])*r.scale[0];
+      o.position.y = r.min[1] + float(src[1])*r.scale[1];
+      o.position.z = r.min[2] + float(src[2])*r.scale[2];
+      }
+    }
+  }
+
+AnimSamples::Stat AnimSamples::stat() {
+  Stat s;
+  s.rawBytes    = statRawBytes;
+  s.packedBytes = statPackedBytes;
+  return s;
+  }
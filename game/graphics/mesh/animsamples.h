@@ -0,0 +1,61 @@
+#pragma once
+
+#include <zenkit/ModelAnimation.hh>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Compressed animation samples. Constant tracks are stored once; animated rotations as smallest-three
+// 48-bit quaternions and animated positions as 16-bit values within per-track range.
+// Animated data is frame-major, so each frame is one contiguous block
+class AnimSamples final {
+  public:
+    AnimSamples() = default;
+    AnimSamples(const AnimSamples&) = delete;
+    AnimSamples(AnimSamples&& other);
+    ~AnimSamples();
+
+    AnimSamples& operator = (AnimSamples&& other);
+
+    struct Stat {
+      uint64_t rawBytes    = 0;
+      uint64_t packedBytes = 0;
+      };
+
+    void   pack(const std::vector<zenkit::AnimationSample>& samples, size_t numTracks);
+
+    size_t frameCount() const { return numFrames; }
+    size_t trackCount() const { return tracks.size(); }
+
+    // tracks [begin,begin+count) of frame
+    void   decode(size_t frame, size_t begin, size_t count, zenkit::AnimationSample* out) const;
+
+    static Stat stat();
+
+  private:
+    static constexpr uint32_t Const = uint32_t(-1);
+
+    struct Track {
+      uint32_t                rot = Const; // index within frame block, or Const
+      uint32_t                pos = Const;
+      zenkit::AnimationSample value;       // constant part of track
+      };
+
+    struct PosRange {
+      float min  [3] = {};
+      float scale[3] = {};
+      };
+
+    void   release();
+    size_t byteSize() const;
+
+    std::vector<Track>    tracks;
+    std::vector<PosRange> posRange;
+    std::vector<uint16_t> rot;  // [frame][rotCount][3]
+    std::vector<uint16_t> pos;  // [frame][posCount][3]
+    uint32_t              rotCount  = 0;
+    uint32_t              posCount  = 0;
+    size_t                numFrames = 0;
+    uint64_t              rawBytes  = 0;
+  };
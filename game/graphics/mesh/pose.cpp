@@ -9,7 +9,9 @@
 #include "skeleton.h"
 #include "animmath.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 using namespace Tempest;
 
@@ -97,6 +99,7 @@ void Pose::load(Serialize &fin, const AnimationSolver& solver) {
     onAddLayer(i);
   fin.read(headRotX,headRotY);
   needToUpdate = true;
+  lodBlend     = false;
 
   numBones = skeleton==nullptr ? 0 : skeleton->nodes.size();
   for(auto& i:hasSamples)
@@ -150,6 +153,7 @@ void Pose::setSkeleton(const Skeleton* sk) {
     i = S_None;
   trY          = skeleton->rootTr.y;
   needToUpdate = true;
+  lodBlend     = false;
   if(lay.size()>0) //TODO
     Log::d("WARNING: ",__func__," animation adjustment is not implemented");
   lay.clear();
@@ -325,7 +329,28 @@ bool Pose::update(uint64_t tickCount, bool force) {
     }
 
   bool needMkSkeleton = false;
-  if(lastUpdate!=tickCount || force) {
+  if(lastUpdate!=tickCount && !force && tickCount-lastSample<lodInterval) {
+    // sampling is throttled by LOD; skeleton still has to follow object
+    lastUpdate     = tickCount;
+    needMkSkeleton = lodMoved;
+    lodMoved       = false;
+    if(lodBlend) {
+      // displayed pose trails sampling by one interval: move from previous sample towards last one
+      float a = 1.f;
+      if(lodInterval!=std::numeric_limits<uint64_t>::max())
+        a = std::min(1.f, float(tickCount-lastSample)/float(lodInterval));
+      mix(lodFrom,lodTo,a,base,numBones);
+      lodBlend       = a<1.f;
+      needMkSkeleton = true;
+      }
+    }
+  else if(lastUpdate!=tickCount || force) {
+    // interval has passed: previous sample is reached and becomes start of the next blend
+    const bool blend = (lodInterval>0 && !force && lastSample>0);
+    if(blend) {
+      const auto* src = lodBlend ? lodTo : base;
+      std::copy(src,src+numBones,lodFrom);
+      }
     for(auto& i:lay) {
       const Animation::Sequence* seq = i.seq;
       if(0<i.comb && i.comb<=i.seq->comb.size()) {
@@ -341,7 +366,14 @@ bool Pose::update(uint64_t tickCount, bool force) {
       needMkSkeleton |= updateFrame(*seq,i.bs,i.sBlend,lastUpdate,i.sAnim,tickCount);
       }
     lastUpdate   = tickCount;
+    lastSample   = tickCount;
+    lodMoved     = false;
+    lodBlend     = blend && needMkSkeleton;
     needToUpdate = needMkSkeleton;
+    if(lodBlend) {
+      std::copy(base,   base+numBones,   lodTo);
+      std::copy(lodFrom,lodFrom+numBones,base);
+      }
     }
 
   if(needMkSkeleton || force) {
@@ -351,12 +383,17 @@ bool Pose::update(uint64_t tickCount, bool force) {
   return false;
   }
 
+void Pose::setAnimLod(uint64_t interval, bool skipMinor) {
+  lodInterval  = interval;
+  lodSkipMinor = skipMinor;
+  }
+
 bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBlend,
                        uint64_t barrier, uint64_t sTime, uint64_t now) {
   auto&        d         = *s.data;
   const size_t idSize    = d.nodeIndex.size();
   const size_t numFrames = d.numFrames;
-  if(numFrames==0 || idSize==0 || d.samples.size()%idSize!=0)
+  if(numFrames==0 || idSize==0 || d.samples.trackCount()!=idSize || d.samples.frameCount()<numFrames)
     return false; // error
 
   (void)barrier;
@@ -382,17 +419,27 @@ bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBle
     frameB = d.numFrames-1-frameB;
     }
 
-  auto* sampleA = &d.samples[size_t(frameA*idSize)];
-  auto* sampleB = &d.samples[size_t(frameB*idSize)];
-
   const uint64_t blendMax = std::max(s.blendOut,s.blendIn);
   const uint64_t blend    = std::max<uint64_t>(0, now-sBlend);
 
+  // decode and interpolate in batches, whole skeleton at once in practice
+  const size_t            chunk = Resources::MAX_NUM_SKELETAL_NODES;
+  zenkit::AnimationSample sampleA[Resources::MAX_NUM_SKELETAL_NODES];
+  zenkit::AnimationSample sampleB[Resources::MAX_NUM_SKELETAL_NODES];
+  zenkit::AnimationSample samples[Resources::MAX_NUM_SKELETAL_NODES];
   for(size_t i=0; i<idSize; ++i) {
+    if(i%chunk==0) {
+      const size_t count = std::min(idSize-i,chunk);
+      d.samples.decode(size_t(frameA),i,count,sampleA);
+      d.samples.decode(size_t(frameB),i,count,sampleB);
+      mix(sampleA,sampleB,a,samples,count);
+      }
     size_t idx = d.nodeIndex[i];
     if(idx>=numBones)
       continue;
-    auto smp = mix(sampleA[i],sampleB[i],a);
+    if(lodSkipMinor && hasSamples[idx]!=S_None && skeleton->nodes[idx].minor)
+      continue;
+    auto smp = samples[i%chunk];
     if(i==0) {
       if(bs==BS_CLIMB)
         smp.position.y = trY;
@@ -441,13 +488,16 @@ void Pose::implMkSkeleton(const Matrix4x4 &mt) {
     return;
   auto& nodes      = skeleton->nodes;
   auto  BIP01_HEAD = skeleton->BIP01_HEAD;
+
+  Matrix4x4 local[Resources::MAX_NUM_SKELETAL_NODES];
+  mkMatrix(base,local,nodes.size());
   for(size_t i=0; i<nodes.size(); ++i) {
     size_t parent = nodes[i].parent;
-    auto   mat    = hasSamples[i] ? mkMatrix(base[i]) : nodes[i].tr;
+    auto&  mat    = hasSamples[i] ? local[i] : nodes[i].tr;
 
     if(parent<Resources::MAX_NUM_SKELETAL_NODES)
-      tr[i] = tr[parent]*mat; else
-      tr[i] = mt*mat;
+      mulMatrix(tr[parent],mat,tr[i]); else
+      mulMatrix(mt,mat,tr[i]);
 
     if(i==BIP01_HEAD && (headRotX!=0 || headRotY!=0)) {
       Matrix4x4& m = tr[i];
@@ -597,6 +647,7 @@ void Pose::setObjectMatrix(const Tempest::Matrix4x4& obj, bool sync) {
   if(sync)
     mkSkeleton(pos); else
     needToUpdate = true;
+  lodMoved = !sync;
   }
 
 Tempest::Vec3 Pose::animMoveSpeed(uint64_t tickCount, uint64_t dt) const {
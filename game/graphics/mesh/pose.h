@@ -48,6 +48,7 @@ class Pose final {
 
     void               setObjectMatrix(const Tempest::Matrix4x4& obj, bool sync);
     bool               update(uint64_t tickCount, bool force);
+    void               setAnimLod(uint64_t interval, bool skipMinor);
 
     void               processLayers(AnimationSolver &solver, uint64_t tickCount);
     bool               processEvents(uint64_t& barrier, uint64_t now, Animation::EvCount &ev) const;
@@ -139,6 +140,11 @@ class Pose final {
     float                           trY=0;
     Flags                           flag=NoFlags;
     uint64_t                        lastUpdate=0;
+    uint64_t                        lastSample=0;
+    uint64_t                        lodInterval=0;   // ms, between samples
+    bool                            lodSkipMinor=false;
+    bool                            lodMoved=false;
+    bool                            lodBlend=false;  // base is interpolated from lodFrom to lodTo
     ComboState                      combo;
     bool                            needToUpdate = true;
     uint8_t                         hasEvents = 0;
@@ -151,6 +157,8 @@ class Pose final {
     SampleStatus                    hasSamples[Resources::MAX_NUM_SKELETAL_NODES] = {};
     zenkit::AnimationSample         base      [Resources::MAX_NUM_SKELETAL_NODES] = {};
     zenkit::AnimationSample         prev      [Resources::MAX_NUM_SKELETAL_NODES] = {};
+    zenkit::AnimationSample         lodFrom   [Resources::MAX_NUM_SKELETAL_NODES] = {};
+    zenkit::AnimationSample         lodTo     [Resources::MAX_NUM_SKELETAL_NODES] = {};
     Tempest::Matrix4x4              tr        [Resources::MAX_NUM_SKELETAL_NODES] = {};
     Tempest::Matrix4x4              pos;
   };
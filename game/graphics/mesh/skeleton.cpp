@@ -23,6 +23,7 @@ Skeleton::Skeleton(const zenkit::ModelHierarchy& src, const Animation* anim, std
 
     n.name   = s.name;
     n.parent = s.parent_index == -1 ? size_t(-1) : size_t(s.parent_index);
+    n.minor  = n.name.find("FINGER")!=std::string::npos || n.name.find("TOE")!=std::string::npos;
 
     auto transposed_transform = s.transform;
     std::memcpy(reinterpret_cast<void*>(&n.tr),reinterpret_cast<const void*>(&transposed_transform),sizeof(n.tr));
@@ -16,6 +16,7 @@ class Skeleton final {
       size_t             parent=size_t(-1);
       Tempest::Matrix4x4 tr;
       std::string        name;
+      bool               minor = false; // fingers and toes: not sampled by distant LOD
       };
 
     bool                            ordered=true;
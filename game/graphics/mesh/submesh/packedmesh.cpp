@@ -5,8 +5,11 @@
 #include <cassert>
 #include <fstream>
 #include <algorithm>
+#include <type_traits>
+#include <cstring>
 
 #include "game/compatibility/phoenix.h"
+#include "utils/diskcache.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -43,6 +46,64 @@ static bool isVisuallySame(const zenkit::Material& a, const zenkit::Material& b)
     a.default_mapping              == b.default_mapping;
   }
 
+namespace {
+// layout of landscape in disk-cache; followed by arrays in same order
+struct CacheHeader {
+  uint64_t vertices      = 0;
+  uint64_t indices       = 0;
+  uint64_t indices8      = 0;
+  uint64_t meshletBounds = 0;
+  uint64_t bvhNodes      = 0;
+  uint64_t bvh8Nodes     = 0;
+  uint64_t subMeshes     = 0;
+  };
+
+struct CacheSubMesh {
+  uint32_t material  = 0;
+  uint32_t padding   = 0;
+  uint64_t iboOffset = 0;
+  uint64_t iboLength = 0;
+  };
+}
+
+static DiskCache& meshCache() {
+  static DiskCache cache("meshes", 1);
+  return cache;
+  }
+
+static std::string cacheKey(uint64_t hash) {
+  // bvh is only present with software ray-tracing
+  const bool rt = Gothic::inst().options().doSoftwareRT;
+  char buf[32] = {};
+  std::snprintf(buf, sizeof(buf), "%016llx%s", static_cast<unsigned long long>(hash), rt ? "-rt" : "");
+  return buf;
+  }
+
+static size_t alignCache(size_t sz) {
+  return ((sz+DiskCache::Alignment-1)/DiskCache::Alignment)*DiskCache::Alignment;
+  }
+
+template<class T>
+static uint64_t hashBytes(uint64_t h, const std::vector<T>& data) {
+  // 64-bit multiply-xorshift over words; not cryptographic, only to detect changed content
+  static_assert(std::is_trivially_copyable_v<T>);
+  const uint64_t k     = 0x9E3779B97F4A7C15ull;
+  const auto*    bytes = reinterpret_cast<const uint8_t*>(data.data());
+  const size_t   size  = data.size()*sizeof(T);
+
+  h ^= uint64_t(size)*k;
+  size_t i = 0;
+  for(; i+8<=size; i+=8) {
+    uint64_t w = 0;
+    std::memcpy(&w, bytes+i, 8);
+    h = (h ^ w) * k;
+    h ^= h >> 29;
+    }
+  for(; i<size; ++i)
+    h = (h ^ bytes[i]) * k;
+  return h ^ (h >> 32);
+  }
+
 static float areaOf(const Vec3 sahMin, const Vec3 sahMax) {
   auto sz = sahMax - sahMin;
   return 2*(sz.x*sz.y + sz.x*sz.z + sz.y*sz.z);
@@ -406,15 +467,25 @@ void PackedMesh::Meshlet::merge(const Meshlet& other) {
 
 
 PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type) {
-  if(type==PK_VisualLnd && Gothic::inst().options().doSoftwareRT) {
-    packBVH(mesh);
-    }
-
   if(type==PK_VisualLnd) {
     // dbgMesh(mesh);
+    const uint64_t time0 = Application::tickCount();
+    const uint64_t hash  = meshHash(mesh);
+    if(loadCache(mesh,hash)) {
+      Log::i("PackedMesh: landscape loaded from cache in ", Application::tickCount()-time0, "ms");
+      return;
+      }
+
+    if(Gothic::inst().options().doSoftwareRT)
+      packBVH(mesh);
+    packMeshletsLnd(mesh);
+    computeBbox();
+    storeCache(hash);
+    Log::i("PackedMesh: landscape packed in ", Application::tickCount()-time0, "ms");
+    return;
     }
 
-  if(type==PK_VisualLnd || type==PK_Visual) {
+  if(type==PK_Visual) {
     packMeshletsLnd(mesh);
     computeBbox();
     return;
@@ -1232,21 +1303,7 @@ void PackedMesh::packMeshletsLnd(const zenkit::Mesh& mesh) {
   auto& ibo  = mesh.polygons.vertex_indices;
   auto& feat = mesh.polygons.feature_indices;
   auto& mid  = mesh.polygons.material_indices;
-
-  std::vector<uint32_t> mat(mesh.materials.size());
-  for(size_t i=0; i<mesh.materials.size(); ++i)
-    mat[i] = uint32_t(i);
-
-  for(size_t i=0; i<mesh.materials.size(); ++i) {
-    for(size_t r=i+1; r<mesh.materials.size(); ++r) {
-      if(mat[i]==mat[r])
-        continue;
-      auto& a = mesh.materials[i];
-      auto& b = mesh.materials[r];
-      if(isVisuallySame(a,b))
-        mat[r] = mat[i];
-      }
-    }
+  auto  mat  = materialRemap(mesh);
 
   std::vector<Prim> prim;
   prim.reserve(mid.size());
@@ -1297,13 +1354,33 @@ void PackedMesh::packMeshletsLnd(const zenkit::Mesh& mesh) {
     for(auto& i:meshlets)
       i.flush(vertices,indices,indices8,meshletBounds,mesh);
     pack.iboLength = indices.size() - pack.iboOffset;
-    if(pack.iboLength>0)
+    if(pack.iboLength>0) {
       subMeshes.push_back(std::move(pack));
+      subMeshMaterial.push_back(mId);
+      }
 
     //dbgUtilization(meshlets);
     }
   }
 
+std::vector<uint32_t> PackedMesh::materialRemap(const zenkit::Mesh& mesh) {
+  std::vector<uint32_t> mat(mesh.materials.size());
+  for(size_t i=0; i<mesh.materials.size(); ++i)
+    mat[i] = uint32_t(i);
+
+  for(size_t i=0; i<mesh.materials.size(); ++i) {
+    for(size_t r=i+1; r<mesh.materials.size(); ++r) {
+      if(mat[i]==mat[r])
+        continue;
+      auto& a = mesh.materials[i];
+      auto& b = mesh.materials[r];
+      if(isVisuallySame(a,b))
+        mat[r] = mat[i];
+      }
+    }
+  return mat;
+  }
+
 void PackedMesh::packMeshletsObj(const zenkit::MultiResolutionMesh& mesh, PkgType type,
                                  const std::vector<SkeletalData>* skeletal) {
   auto* vId = (type==PK_VisualMorph) ? &verticesId : nullptr;
@@ -1434,6 +1511,106 @@ bool PackedMesh::addTriangle(Meshlet& dest, const zenkit::Mesh* mesh, const zenk
   return dest.insert(a,b,c);
   }
 
+uint64_t PackedMesh::meshHash(const zenkit::Mesh& mesh) {
+  uint64_t h = 0;
+  h = hashBytes(h, mesh.vertices);
+  h = hashBytes(h, mesh.features);
+  h = hashBytes(h, mesh.polygons.vertex_indices);
+  h = hashBytes(h, mesh.polygons.feature_indices);
+  h = hashBytes(h, mesh.polygons.material_indices);
+  // material merging does affect sub-mesh layout
+  h = hashBytes(h, materialRemap(mesh));
+  return h;
+  }
+
+bool PackedMesh::loadCache(const zenkit::Mesh& mesh, uint64_t hash) {
+  auto blob = meshCache().load(cacheKey(hash), hash);
+  if(blob.isEmpty() || blob.size()<sizeof(CacheHeader))
+    return false;
+
+  CacheHeader hdr;
+  std::memcpy(&hdr, blob.data(), sizeof(hdr));
+
+  size_t at = alignCache(sizeof(hdr));
+  auto   read = [&](auto& vec, uint64_t count) {
+    using T = typename std::decay_t<decltype(vec)>::value_type;
+    const size_t sz = size_t(count)*sizeof(T);
+    if(at>blob.size() || sz>blob.size()-at)
+      return false;
+    vec.resize(size_t(count));
+    std::memcpy(vec.data(), blob.data()+at, sz);
+    at += alignCache(sz);
+    return true;
+    };
+
+  std::vector<CacheSubMesh> sub;
+  if(!read(vertices,      hdr.vertices)      ||
+     !read(indices,       hdr.indices)       ||
+     !read(indices8,      hdr.indices8)      ||
+     !read(meshletBounds, hdr.meshletBounds) ||
+     !read(bvhNodes,      hdr.bvhNodes)      ||
+     !read(bvh8Nodes,     hdr.bvh8Nodes)     ||
+     !read(sub,           hdr.subMeshes)) {
+    clearCached();
+    return false;
+    }
+
+  subMeshes.resize(sub.size());
+  subMeshMaterial.resize(sub.size());
+  for(size_t i=0; i<sub.size(); ++i) {
+    if(sub[i].material>=mesh.materials.size() || sub[i].iboOffset+sub[i].iboLength>indices.size()) {
+      clearCached();
+      return false;
+      }
+    subMeshes[i].material  = mesh.materials[sub[i].material];
+    subMeshes[i].iboOffset = size_t(sub[i].iboOffset);
+    subMeshes[i].iboLength = size_t(sub[i].iboLength);
+    subMeshMaterial[i]     = sub[i].material;
+    }
+  computeBbox();
+  return true;
+  }
+
+void PackedMesh::storeCache(uint64_t hash) const {
+  CacheHeader hdr;
+  hdr.vertices      = vertices.size();
+  hdr.indices       = indices.size();
+  hdr.indices8      = indices8.size();
+  hdr.meshletBounds = meshletBounds.size();
+  hdr.bvhNodes      = bvhNodes.size();
+  hdr.bvh8Nodes     = bvh8Nodes.size();
+  hdr.subMeshes     = subMeshes.size();
+
+  std::vector<CacheSubMesh> sub(subMeshes.size());
+  for(size_t i=0; i<sub.size(); ++i) {
+    sub[i].material  = subMeshMaterial[i];
+    sub[i].iboOffset = subMeshes[i].iboOffset;
+    sub[i].iboLength = subMeshes[i].iboLength;
+    }
+
+  meshCache().store(cacheKey(hash), hash, {
+                      {&hdr,                 sizeof(hdr)},
+                      {vertices.data(),      vertices.size()     *sizeof(vertices[0])},
+                      {indices.data(),       indices.size()      *sizeof(indices[0])},
+                      {indices8.data(),      indices8.size()     *sizeof(indices8[0])},
+                      {meshletBounds.data(), meshletBounds.size()*sizeof(meshletBounds[0])},
+                      {bvhNodes.data(),      bvhNodes.size()     *sizeof(bvhNodes[0])},
+                      {bvh8Nodes.data(),     bvh8Nodes.size()    *sizeof(bvh8Nodes[0])},
+                      {sub.data(),           sub.size()          *sizeof(sub[0])},
+                      });
+  }
+
+void PackedMesh::clearCached() {
+  vertices.clear();
+  indices.clear();
+  indices8.clear();
+  meshletBounds.clear();
+  bvhNodes.clear();
+  bvh8Nodes.clear();
+  subMeshes.clear();
+  subMeshMaterial.clear();
+  }
+
 void PackedMesh::debug(std::ostream &out) const {
   for(auto& i:vertices) {
     out << "v  " << i.pos[0]  << " " << i.pos[1]  << " " << i.pos[2]  << std::endl;
@@ -89,7 +89,8 @@ class PackedMesh {
     std::pair<Tempest::Vec3,Tempest::Vec3> bbox() const;
 
   private:
-    Tempest::Vec3 mBbox[2];
+    Tempest::Vec3         mBbox[2];
+    std::vector<uint32_t> subMeshMaterial; // index in source mesh, only for landscape
 
     struct Prim {
       uint32_t primId = 0;
@@ -176,6 +177,13 @@ class PackedMesh {
 
     bool   addTriangle(Meshlet& dest, const zenkit::Mesh* mesh, const zenkit::SubMesh* proto_mesh, size_t id);
 
+    // disk-cache of packed landscape
+    static auto     materialRemap(const zenkit::Mesh& mesh) -> std::vector<uint32_t>;
+    static uint64_t meshHash(const zenkit::Mesh& mesh);
+    bool            loadCache(const zenkit::Mesh& mesh, uint64_t hash);
+    void            storeCache(uint64_t hash) const;
+    void            clearCached();
+
     void   packPhysics(const zenkit::Mesh& mesh, PkgType type);
 
     // bvh common
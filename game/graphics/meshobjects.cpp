@@ -49,6 +49,14 @@ const Tempest::Texture2d *MeshObjects::solveTex(const Tempest::Texture2d *def, s
   return def;
   }
 
+Resources::Future<Tempest::Texture2d> MeshObjects::streamTex(const Tempest::Texture2d* def, std::string_view format, int32_t v, int32_t c) {
+  // body and armor variants: draw with default variant, until requested one is loaded
+  if(def==nullptr || format.find_first_of("VC")==std::string::npos)
+    return Resources::Future<Tempest::Texture2d>();
+  // queue as farthest: VisualObjects sets real distance to camera, once object is placed
+  return Resources::loadTextureAsync(format,v,c,std::numeric_limits<float>::max());
+  }
+
 void MeshObjects::Mesh::setSkeleton(const Skeleton *sk) {
   skeleton = sk;
   if(proto!=nullptr && skeleton!=nullptr)
@@ -159,9 +167,16 @@ MeshObjects::Mesh::Mesh(MeshObjects& owner, const ProtoMesh& mesh,
     auto& skin = mesh.skined[i];
     for(auto& m:skin.sub) {
       Material mat = m.material;
-      mat.tex=owner.solveTex(mat.tex,m.texName,texVar,bodyColor);
+      auto     tex   = owner.streamTex(mat.tex,m.texName,texVar,bodyColor);
+      bool     ready = tex.isReady();
+      if(tex.isEmpty())
+        mat.tex = owner.solveTex(mat.tex,m.texName,texVar,bodyColor);
+      else if(ready && tex.get()!=nullptr)
+        mat.tex = tex.get();
       if(mat.tex!=nullptr) {
         sub[subCount] = owner.parent.get(skin,mat,m.iboOffset,m.iboSize,*anim);
+        if(!tex.isEmpty() && !ready)
+          sub[subCount].streamTexture(std::move(tex),mat.tex);
         ++subCount;
         } else {
         if(!m.texName.empty())
@@ -90,4 +90,6 @@ class MeshObjects final {
 
     const Tempest::Texture2d*       solveTex(const Tempest::Texture2d* def, std::string_view format,
                                              int32_t v,int32_t c);
+    auto                            streamTex(const Tempest::Texture2d* def, std::string_view format,
+                                              int32_t v, int32_t c) -> Resources::Future<Tempest::Texture2d>;
   };
@@ -276,6 +276,11 @@ bool ObjVisual::updateAnimation(Npc* npc, Interactive* mobsi, World& world, uint
   return false;
   }
 
+void ObjVisual::setAnimLod(uint64_t interval, bool skipMinor) {
+  if(type==M_Mdl)
+    mdl.view.setAnimLod(interval,skipMinor);
+  }
+
 void ObjVisual::processLayers(World& world) {
   if(type==M_Mdl) {
     mdl.view.processLayers(world);
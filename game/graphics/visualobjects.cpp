@@ -63,6 +63,12 @@ void VisualObjects::Item::setAsGhost(bool g) {
     }
   }
 
+void VisualObjects::Item::streamTexture(Resources::Future<Tempest::Texture2d> tex, const Tempest::Texture2d* def) {
+  if(owner!=nullptr) {
+    owner->streamTexture(id, std::move(tex), def);
+    }
+  }
+
 void VisualObjects::Item::setFatness(float f) {
   if(owner!=nullptr) {
     if(owner->objects[id].fatness == f)
@@ -327,6 +333,7 @@ void VisualObjects::free(size_t id) {
     objectsWind.erase(id);
   if(obj.type==DrawCommands::Morph)
     objectsMorph.erase(id);
+  objectsStream.erase(id);
 
   obj = Object();
   while(objects.size()>0) {
@@ -432,16 +439,27 @@ void VisualObjects::setAsGhost(size_t id, bool g) {
   if(obj.isGhost==g)
     return;
 
+  auto mat = obj.bucketId->mat;
+  mat.alpha   = g ? Material::Ghost : obj.alpha;
+  obj.isGhost = g;
+  implSetMaterial(id, mat);
+  }
+
+void VisualObjects::streamTexture(size_t id, Resources::Future<Texture2d> tex, const Texture2d* def) {
+  auto& obj = objects[id];
+  obj.texStream  = std::move(tex);
+  obj.texDefault = def;
+  objectsStream.insert(id);
+  }
+
+void VisualObjects::implSetMaterial(size_t id, const Material& mat) {
+  auto& obj = objects[id];
   auto& bx  = *obj.bucketId;
   auto& cx  = drawCmd[obj.cmdId];
-  auto  mat = bx.mat;
 
   const uint32_t meshletCount = (obj.iboLen/PackedMesh::MaxInd);
   drawCmd.addClusters(obj.cmdId, -meshletCount);
 
-  mat.alpha   = g ? Material::Ghost : obj.alpha;
-  obj.isGhost = g;
-
   if(bx.staticMesh!=nullptr)
     obj.bucketId = bucketsMem.alloc(mat, *bx.staticMesh); else
     obj.bucketId = bucketsMem.alloc(mat, *bx.animMesh);
@@ -467,6 +485,34 @@ void VisualObjects::prepareGlobals(Encoder<CommandBuffer>& enc, uint8_t fId) {
 void VisualObjects::preFrameUpdate() {
   preFrameUpdateWind();
   preFrameUpdateMorph();
+  preFrameUpdateStream();
+  }
+
+void VisualObjects::preFrameUpdateStream() {
+  for(auto it=objectsStream.begin(); it!=objectsStream.end(); ) {
+    auto& obj = objects[*it];
+    if(!obj.texStream.isReady()) {
+      auto pos = Vec3(obj.pos[3][0], obj.pos[3][1], obj.pos[3][2]);
+      obj.texStream.setPriority((pos-scene.originLwc).length());
+      ++it;
+      continue;
+      }
+
+    auto tex = obj.texStream.get();
+    if(tex==nullptr)
+      tex = obj.texDefault;
+    const size_t id = *it;
+    it = objectsStream.erase(it);
+
+    obj.texStream  = Resources::Future<Texture2d>();
+    obj.texDefault = nullptr;
+    if(tex==nullptr || tex==obj.bucketId->mat.tex)
+      continue;
+    auto mat = obj.bucketId->mat;
+    mat.tex = tex;
+    implSetMaterial(id, mat);
+    }
+  Resources::updateStreamPriorities();
   }
 
 void VisualObjects::preFrameUpdateWind() {
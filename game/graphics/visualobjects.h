@@ -42,6 +42,8 @@ class VisualObjects final {
       void     setFatness  (float f);
       void     setWind     (zenkit::AnimationType m, float intensity);
       void     startMMAnim (std::string_view anim, float intensity, uint64_t timeUntil);
+      // draws with current texture, until streamed one is ready; def is used, if streaming fails
+      void     streamTexture(Resources::Future<Tempest::Texture2d> tex, const Tempest::Texture2d* def);
 
       const Material&    material() const;
       const Bounds&      bounds()   const;
@@ -121,10 +123,14 @@ class VisualObjects final {
       float               windIntensity = 0;
       float               fatness       = 0;
       bool                isGhost       = false;
+
+      Resources::Future<Tempest::Texture2d> texStream;
+      const Tempest::Texture2d*             texDefault = nullptr;
       };
 
     void     preFrameUpdateWind();
     void     preFrameUpdateMorph();
+    void     preFrameUpdateStream();
 
     size_t   implAlloc();
     void     free(size_t id);
@@ -134,6 +140,8 @@ class VisualObjects final {
 
     void     startMMAnim(size_t i, std::string_view animName, float intensity, uint64_t timeUntil);
     void     setAsGhost(size_t i, bool g);
+    void     streamTexture(size_t i, Resources::Future<Tempest::Texture2d> tex, const Tempest::Texture2d* def);
+    void     implSetMaterial(size_t i, const Material& mat);
 
     void     notifyTlas(const Material& m, RtScene::Category cat);
     void     updateInstance(size_t id, Tempest::Matrix4x4* pos = nullptr);
@@ -152,6 +160,7 @@ class VisualObjects final {
     std::vector<Object>        objects;
     std::unordered_set<size_t> objectsWind;
     std::unordered_set<size_t> objectsMorph;
+    std::unordered_set<size_t> objectsStream;
     std::unordered_set<size_t> objectsFree;
 
     friend class Item;
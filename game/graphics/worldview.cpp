@@ -4,6 +4,7 @@
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/world.h"
+#include "utils/workers.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -57,8 +58,11 @@ void WorldView::preFrameUpdate(const Camera& camera, uint64_t tickCount, uint8_t
   sGlobal.setSky(gSky);
   sGlobal.setWorld(*this);
 
+  auto lights = Workers::spawn([this,tickCount](){
+    gLights.tick(tickCount);
+    });
   pfxGroup.tick(tickCount);
-  gLights.tick(tickCount);
+  Workers::wait(lights);
   sGlobal.setTime(tickCount);
   sGlobal.commitUbo(fId);
 
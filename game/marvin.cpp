@@ -5,9 +5,11 @@
 #include <cctype>
 
 #include "utils/string_frm.h"
+#include "utils/workers.h"
 #include "world/objects/npc.h"
 #include "world/objects/item.h"
 #include "world/triggers/abstracttrigger.h"
+#include "graphics/mesh/animsamples.h"
 #include "camera.h"
 #include "gothic.h"
 
@@ -150,6 +152,11 @@ Marvin::Marvin() {
     {"toggle vsm",                 C_ToggleVsm},
     {"toggle rtsm",                C_ToggleRtsm},
     {"toggle pathtrace",           C_TogglePathtrace},
+    {"workers stats",              C_WorkersStats},
+    {"resources stats",            C_ResourcesStats},
+    {"los stats",                  C_LosStats},
+    {"trigger stats",              C_TriggerStats},
+    {"path stats",                 C_PathStats},
     };
   }
 
@@ -476,6 +483,16 @@ bool Marvin::exec(std::string_view v) {
     case C_TogglePathtrace:
       Gothic::inst().togglePathtrace();
       return true;
+    case C_WorkersStats:
+      return printWorkersStats();
+    case C_ResourcesStats:
+      return printResourcesStats();
+    case C_LosStats:
+      return printLosStats();
+    case C_TriggerStats:
+      return printTriggerStats();
+    case C_PathStats:
+      return printPathStats();
     }
 
   return true;
@@ -609,6 +626,57 @@ bool Marvin::goToVob(World& world, Npc& player, Camera& c, std::string_view name
   return true;
   }
 
+bool Marvin::printWorkersStats() {
+  print(string_frm("threads: ",Workers::maxThreads()));
+  for(auto& i:Workers::callSiteStats()) {
+    string_frm<128> buf(i.file,":",i.line," calls: ",size_t(i.calls)," ns/item: ",i.nsPerItem," step: ",i.step," threads: ",i.threads);
+    print(buf);
+    }
+  return true;
+  }
+
+bool Marvin::printResourcesStats() {
+  for(auto& i:Resources::cacheStats()) {
+    string_frm buf(i.name," hit: ",size_t(i.hit)," miss: ",size_t(i.miss)," contended: ",size_t(i.contended));
+    print(buf);
+    }
+  auto anim = AnimSamples::stat();
+  print(string_frm("animation samples KiB: ",size_t(anim.packedBytes/1024)," uncompressed KiB: ",size_t(anim.rawBytes/1024)));
+  return true;
+  }
+
+bool Marvin::printLosStats() {
+  World* world = Gothic::inst().world();
+  if(world==nullptr)
+    return false;
+  auto  st    = world->physic()->losStat();
+  auto  total = st.hit+st.miss;
+  float rate  = total>0 ? float(st.hit)/float(total) : 0.f;
+  print(string_frm("los hit: ",size_t(st.hit)," miss: ",size_t(st.miss)," hit-rate: ",rate," entries: ",st.size));
+  return true;
+  }
+
+bool Marvin::printTriggerStats() {
+  World* world = Gothic::inst().world();
+  if(world==nullptr)
+    return false;
+  auto st = world->triggerStat();
+  print(string_frm("triggers: ",st.triggers," names: ",st.names," events/frame: ",st.dispatched));
+  return true;
+  }
+
+bool Marvin::printPathStats() {
+  World* world = Gothic::inst().world();
+  if(world==nullptr)
+    return false;
+  auto  st    = world->pathStat();
+  auto  total = st.hit+st.miss;
+  float rate  = total>0 ? float(st.hit)/float(total) : 0.f;
+  print(string_frm("path hit: ",size_t(st.hit)," miss: ",size_t(st.miss)," hit-rate: ",rate,
+                   " entries: ",st.size," KiB: ",st.bytes/1024));
+  return true;
+  }
+
 std::string_view Marvin::completeInstanceName(std::string_view inp, bool& fullword) const {
   World* world  = Gothic::inst().world();
   if(world==nullptr || inp.size()==0)
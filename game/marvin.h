@@ -67,6 +67,11 @@ class Marvin {
       C_ToggleVsm,
       C_ToggleRtsm,
       C_TogglePathtrace,
+      C_WorkersStats,
+      C_ResourcesStats,
+      C_LosStats,
+      C_TriggerStats,
+      C_PathStats,
       };
 
     struct Cmd {
@@ -95,6 +100,11 @@ class Marvin {
     bool   setVariable             (World* world, std::string_view name, std::string_view value);
     bool   setTime                 (World& world, std::string_view hh, std::string_view mm);
     bool   goToVob                 (World& world, Npc& player, Camera& c, std::string_view name, size_t n);
+    bool   printWorkersStats       ();
+    bool   printResourcesStats     ();
+    bool   printLosStats           ();
+    bool   printTriggerStats       ();
+    bool   printPathStats          ();
 
     std::vector<Cmd> cmd;
   };
@@ -750,6 +750,28 @@ DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const T
   return ret;
   }
 
+bool DynamicWorld::rayLos(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  bool visible = false;
+  if(losCache.find(observer,from,to,visible))
+    return visible;
+  visible = !ray(from,to).hasCol;
+  losCache.push(observer,from,to,visible);
+  return visible;
+  }
+
+void DynamicWorld::invalidateLos(const btCollisionObject& obj) const {
+  // only rays, that cross the body, are affected
+  btVector3 aabb0, aabb1;
+  obj.getCollisionShape()->getAabb(obj.getWorldTransform(), aabb0, aabb1);
+  const auto min = Tempest::Vec3(aabb0.x()*100.f, aabb0.y()*100.f, aabb0.z()*100.f);
+  const auto max = Tempest::Vec3(aabb1.x()*100.f, aabb1.y()*100.f, aabb1.z()*100.f);
+  losCache.invalidate(min,max);
+  }
+
+LosCache::Stat DynamicWorld::losStat() const {
+  return losCache.stat();
+  }
+
 DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, const Tempest::Vec3& to, const Npc* except) const {
   RayQueryResult r;
   static_cast<RayLandResult&>(r) = ray(from,to);
@@ -836,6 +858,7 @@ DynamicWorld::Item DynamicWorld::createObj(btCollisionShape* shape, bool ownShap
     case IT_Static:
       obj = world->addCollisionBody(*shape,m,friction);
       obj->setUserIndex(C_Object);
+      invalidateLos(*obj);
       break;
     case IT_Dynamic:
       obj = world->addDynamicBody(*shape,m,friction,mass);
@@ -975,10 +998,15 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
     }
   }
 
+void DynamicWorld::updateAabbs() {
+  world->updateAabbs();
+  }
+
 void DynamicWorld::tick(uint64_t dt) {
   npcList   ->tickAabbs();
   bulletList->tick(dt);
   world     ->tick(dt);
+  losCache   .tick(dt);
   }
 
 void DynamicWorld::deleteObj(BulletBody* obj) {
@@ -1292,6 +1320,8 @@ bool DynamicWorld::NpcItem::hasCollision() const {
   }
 
 DynamicWorld::Item::~Item() {
+  if(obj!=nullptr && obj->getUserIndex()==C_Object)
+    owner->invalidateLos(*obj);
   delete obj;
   delete shp;
   }
@@ -1303,9 +1333,15 @@ void DynamicWorld::Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
     trans.getOrigin()*=0.01f;
     if(obj->getWorldTransform()==trans)
       return;
+    // movers, animated mobsi: rays through old and new placement
+    const bool los = obj->getUserIndex()==C_Object;
+    if(los)
+      owner->invalidateLos(*obj);
     obj->setWorldTransform(trans);
     //owner->world->touchAabbs(); // TOO SLOW!
     owner->world->updateSingleAabb(obj);
+    if(los)
+      owner->invalidateLos(*obj);
     }
   }
 
@@ -6,6 +6,8 @@
 #include <memory>
 #include <limits>
 
+#include "loscache.h"
+
 class btTriangleIndexVertexArray;
 class btCollisionShape;
 class btCollisionObject;
@@ -249,6 +251,9 @@ class DynamicWorld final {
 
     RayLandResult  ray          (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     RayQueryResult rayNpc       (const Tempest::Vec3& from, const Tempest::Vec3& to, const Npc* except) const;
+    // same as !ray(from,to).hasCol, but result is cached per observer
+    bool           rayLos       (uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    auto           losStat() const -> LosCache::Stat;
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
 
     NpcItem        ghostObj  (const Skeleton* src);
@@ -261,6 +266,8 @@ class DynamicWorld final {
     BBoxBody       bboxObj(BBoxCallback* cb, const Tempest::Vec3& pos, float R);
 
     void           tick(uint64_t dt);
+    // flush pending aabb changes: ray queries after that are read-only and can run on workers
+    void           updateAabbs();
 
     void           deleteObj(BulletBody* obj);
 
@@ -289,6 +296,7 @@ class DynamicWorld final {
     void           moveBullet(BulletBody& b, const Tempest::Vec3& dir, uint64_t dt);
     RayWaterResult implWaterRay(const Tempest::Vec3& from, const Tempest::Vec3& to, float stepHeight) const;
     bool           hasCollision(const NpcItem &it, CollisionTest& out);
+    void           invalidateLos(const btCollisionObject& obj) const;
 
     std::unique_ptr<CollisionWorld>    world;
 
@@ -306,6 +314,7 @@ class DynamicWorld final {
     std::unique_ptr<NpcBodyList>       npcList;
     std::unique_ptr<BulletsList>       bulletList;
     std::unique_ptr<BBoxList>          bboxList;
+    mutable LosCache                   losCache;
 
     static const float                 worldHeight;
   };
@@ -0,0 +1,126 @@
+#include "loscache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+bool LosCache::Key::operator ==(const Key& other) const {
+  return observer==other.observer &&
+         std::memcmp(from,other.from,sizeof(from))==0 &&
+         std::memcmp(to,  other.to,  sizeof(to)  )==0;
+  }
+
+size_t LosCache::Hash::operator()(const Key& k) const {
+  size_t h = std::hash<uint64_t>()(k.observer);
+  for(int i=0; i<3; ++i) {
+    h = h*31 + std::hash<int32_t>()(k.from[i]);
+    h = h*31 + std::hash<int32_t>()(k.to[i]);
+    }
+  return h;
+  }
+
+uint64_t LosCache::mkObserverId() {
+  static std::atomic<uint64_t> next{1};
+  return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+LosCache::Key LosCache::mkKey(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  Key k;
+  k.observer = observer;
+  k.from[0]  = int32_t(std::floor(from.x/Quantum));
+  k.from[1]  = int32_t(std::floor(from.y/Quantum));
+  k.from[2]  = int32_t(std::floor(from.z/Quantum));
+  k.to[0]    = int32_t(std::floor(to.x/Quantum));
+  k.to[1]    = int32_t(std::floor(to.y/Quantum));
+  k.to[2]    = int32_t(std::floor(to.z/Quantum));
+  return k;
+  }
+
+bool LosCache::find(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to, bool& visible) {
+  const Key k = mkKey(observer,from,to);
+
+  std::lock_guard<std::mutex> guard(sync);
+  auto it = cache.find(k);
+  if(it==cache.end() || it->second.time+Ttl<time) {
+    ++miss;
+    return false;
+    }
+  ++hit;
+  visible = it->second.visible;
+  return true;
+  }
+
+void LosCache::push(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to, bool visible) {
+  const Key k = mkKey(observer,from,to);
+
+  std::lock_guard<std::mutex> guard(sync);
+  auto& e   = cache[k];
+  e.time    = time;
+  e.visible = visible;
+  }
+
+void LosCache::tick(uint64_t dt) {
+  std::lock_guard<std::mutex> guard(sync);
+  time += dt;
+  if(lastEvict+Ttl>time)
+    return;
+  lastEvict = time;
+  for(auto it=cache.begin(); it!=cache.end();) {
+    if(it->second.time+Ttl<time)
+      it = cache.erase(it); else
+      ++it;
+    }
+  }
+
+void LosCache::invalidate() {
+  std::lock_guard<std::mutex> guard(sync);
+  if(!cache.empty())
+    cache.clear();
+  }
+
+void LosCache::invalidate(const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  std::lock_guard<std::mutex> guard(sync);
+  for(auto it=cache.begin(); it!=cache.end();) {
+    if(intersects(it->first,min,max))
+      it = cache.erase(it); else
+      ++it;
+    }
+  }
+
+bool LosCache::intersects(const Key& k, const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  // real end-points are anywhere in their quantum cells: test segment between cell centers
+  // against box, extended by half of the cell
+  const float ext = Quantum*0.5f;
+  const float bmin[3] = {min.x-ext, min.y-ext, min.z-ext};
+  const float bmax[3] = {max.x+ext, max.y+ext, max.z+ext};
+
+  float t0 = 0, t1 = 1;
+  for(int i=0; i<3; ++i) {
+    const float a = (float(k.from[i])+0.5f)*Quantum;
+    const float d = (float(k.to[i])+0.5f)*Quantum - a;
+    if(std::abs(d)<1e-6f) {
+      if(a<bmin[i] || a>bmax[i])
+        return false;
+      continue;
+      }
+    float ta = (bmin[i]-a)/d;
+    float tb = (bmax[i]-a)/d;
+    if(ta>tb)
+      std::swap(ta,tb);
+    t0 = std::max(t0,ta);
+    t1 = std::min(t1,tb);
+    if(t0>t1)
+      return false;
+    }
+  return true;
+  }
+
+LosCache::Stat LosCache::stat() const {
+  std::lock_guard<std::mutex> guard(sync);
+  Stat s;
+  s.hit  = hit;
+  s.miss = miss;
+  s.size = cache.size();
+  return s;
+  }
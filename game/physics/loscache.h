@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Tempest/Point>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+// Results of line-of-sight rays, keyed by observer and quantized ray end-points.
+// Entries expire by time; entries, whose ray crosses a changed collision body, are dropped
+class LosCache final {
+  public:
+    LosCache() = default;
+
+    struct Stat {
+      uint64_t hit  = 0;
+      uint64_t miss = 0;
+      size_t   size = 0;
+      };
+
+    static constexpr float    Quantum = 50.f;  // ray end-points, that moved less than that, map to same entry
+    static constexpr uint64_t Ttl     = 1500;  // ms
+
+    // unique per observer, never reused - unlike address of destroyed npc
+    static uint64_t mkObserverId();
+
+    bool find(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to, bool& visible);
+    void push(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to, bool visible);
+
+    void tick(uint64_t dt);
+    void invalidate();
+    void invalidate(const Tempest::Vec3& min, const Tempest::Vec3& max);
+    Stat stat() const;
+
+  private:
+    struct Key {
+      uint64_t    observer = 0;
+      int32_t     from[3]  = {};
+      int32_t     to  [3]  = {};
+      bool operator == (const Key& other) const;
+      };
+
+    struct Hash {
+      size_t operator()(const Key& k) const;
+      };
+
+    struct Entry {
+      uint64_t time    = 0;
+      bool     visible = false;
+      };
+
+    static Key  mkKey(uint64_t observer, const Tempest::Vec3& from, const Tempest::Vec3& to);
+    static bool intersects(const Key& k, const Tempest::Vec3& min, const Tempest::Vec3& max);
+
+    mutable std::mutex                   sync;
+    std::unordered_map<Key,Entry,Hash>   cache;
+    uint64_t                             time      = 0;
+    uint64_t                             lastEvict = 0;
+    uint64_t                             hit       = 0;
+    uint64_t                             miss      = 0;
+  };
@@ -30,6 +30,7 @@
 #include "dmusic/directmusic.h"
 #include "utils/fileext.h"
 #include "utils/gthfont.h"
+#include "utils/workers.h"
 
 #include "gothic.h"
 #include "utils/string_frm.h"
@@ -51,6 +52,74 @@ static void emplaceTag(char* buf, char tag){
     }
   }
 
+static void mipDown(const uint8_t* src, uint32_t sw, uint32_t sh, uint8_t* dst, uint32_t dw, uint32_t dh) {
+  // 2x2 box filter, clamped for odd/1-pixel dimensions
+  for(uint32_t y=0; y<dh; ++y)
+    for(uint32_t x=0; x<dw; ++x) {
+      const uint32_t x0 = std::min(x*2, sw-1), x1 = std::min(x*2+1, sw-1);
+      const uint32_t y0 = std::min(y*2, sh-1), y1 = std::min(y*2+1, sh-1);
+      for(uint32_t c=0; c<4; ++c) {
+        uint32_t v = uint32_t(src[(y0*sw+x0)*4+c]) + src[(y0*sw+x1)*4+c] + src[(y1*sw+x0)*4+c] + src[(y1*sw+x1)*4+c];
+        dst[(y*dw+x)*4+c] = uint8_t((v+2)/4);
+        }
+      }
+  }
+
+static std::vector<uint8_t> mkRgbaDds(const zenkit::Texture& tex) {
+  // uncompressed RGBA8 DDS with complete mip chain: source mips first, missing levels are box-filtered
+  struct DdsHeader {
+    char     magic[4]      = {'D','D','S',' '};
+    uint32_t size          = 124;
+    uint32_t flags         = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000 | 0x20000; // caps|height|width|pitch|pixelformat|mipcount
+    uint32_t height        = 0;
+    uint32_t width         = 0;
+    uint32_t pitch         = 0;
+    uint32_t depth         = 0;
+    uint32_t mipCount      = 0;
+    uint32_t reserved[11]  = {};
+    uint32_t pfSize        = 32;
+    uint32_t pfFlags       = 0x1 | 0x40; // alphapixels|rgb
+    uint32_t fourCC        = 0;
+    uint32_t bitCount      = 32;
+    uint32_t mask[4]       = {0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000};
+    uint32_t caps          = 0x8 | 0x1000 | 0x400000; // complex|texture|mipmap
+    uint32_t caps2[4]      = {};
+    };
+  static_assert(sizeof(DdsHeader)==128);
+
+  const uint32_t w = tex.width(), h = tex.height();
+  uint32_t levels = 1;
+  while((std::max(w,h)>>levels)>0)
+    ++levels;
+
+  DdsHeader hdr;
+  hdr.width    = w;
+  hdr.height   = h;
+  hdr.pitch    = w*4;
+  hdr.mipCount = levels;
+
+  size_t size = sizeof(hdr);
+  for(uint32_t i=0; i<levels; ++i)
+    size += size_t(std::max(w>>i,1u))*size_t(std::max(h>>i,1u))*4;
+
+  std::vector<uint8_t> ret(size);
+  std::memcpy(ret.data(), &hdr, sizeof(hdr));
+
+  size_t at = sizeof(hdr), prev = 0;
+  for(uint32_t i=0; i<levels; ++i) {
+    const uint32_t lw = std::max(w>>i,1u), lh = std::max(h>>i,1u);
+    if(i<tex.mipmap_count() && tex.mipmap_width(i)==lw && tex.mipmap_height(i)==lh) {
+      auto rgba = tex.as_rgba8(i);
+      std::memcpy(ret.data()+at, rgba.data(), std::min(rgba.size(), size_t(lw)*lh*4));
+      } else {
+      mipDown(ret.data()+prev, std::max(w>>(i-1),1u), std::max(h>>(i-1),1u), ret.data()+at, lw, lh);
+      }
+    prev = at;
+    at  += size_t(lw)*lh*4;
+    }
+  return ret;
+  }
+
 Resources::Resources(Tempest::Device &device)
   : dev(device) {
   inst=this;
@@ -76,9 +145,6 @@ Resources::Resources(Tempest::Device &device)
   // switch-build
   dxMusic->addPath(Gothic::nestedPath({u"_work",u"Data",u"Music"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
   {
   Pixmap pm(1,1,TextureFormat::RGBA8);
   uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
@@ -119,6 +185,9 @@ Resources::Resources(Tempest::Device &device)
 
       return bytes;
   }, this);
+
+  ioTh     = std::thread([this](){ streamIoMain();     });
+  decodeTh = std::thread([this](){ streamDecodeMain(); });
   }
 
 void Resources::mountWork(const std::filesystem::path& path) {
@@ -161,6 +230,7 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
         continue;
 #endif
       inst->gothicAssets.mount_disk(i.name, zenkit::VfsOverwriteBehavior::OLDER);
+      inst->vdfsMap.mount(i.name, i.time);
       }
     catch(const zenkit::VfsBrokenDiskError& err) {
       Log::e("unable to load archive: \"", TextCodec::toUtf8(i.name), "\", reason: ", err.what());
@@ -179,23 +249,34 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
   }
 
 Resources::~Resources() {
+  {
+  std::lock_guard<std::mutex> g(streamSync);
+  streamExit = true;
+  }
+  streamCnd.notify_all();
+  ioTh.join();
+  decodeTh.join();
+
   DmLoader_release(dmLoader);
   inst=nullptr;
   }
 
 bool Resources::hasFile(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->gothicAssets.find(name) != nullptr;
   }
 
 bool Resources::getFileData(std::string_view name, std::vector<uint8_t> &dat) {
   dat.clear();
 
+  if(auto view = getFileView(name); !view.empty()) {
+    dat.assign(view.begin(), view.end());
+    return true;
+    }
+
   const auto* entry = Resources::vdfsIndex().find(name);
   if(entry==nullptr)
     return false;
 
-  // TODO: This should return a buffer!
   auto reader = entry->open_read();
 
   reader->seek(0, zenkit::Whence::END);
@@ -212,7 +293,14 @@ std::vector<uint8_t> Resources::getFileData(std::string_view name) {
   return data;
   }
 
+std::span<const uint8_t> Resources::getFileView(std::string_view name) {
+  return inst->vdfsMap.find(name);
+  }
+
 std::unique_ptr<zenkit::Read> Resources::getFileBuffer(std::string_view name) {
+  if(auto view = getFileView(name); !view.empty())
+    return zenkit::Read::from(reinterpret_cast<const std::byte*>(view.data()), view.size());
+
   const auto* entry = Resources::vdfsIndex().find(name);
   if (entry == nullptr)
     throw std::runtime_error("failed to open resource: " + std::string{name});
@@ -341,26 +429,19 @@ Tempest::Texture2d* Resources::implLoadTexture(std::string_view cname, bool forc
   if(cname.empty())
     return nullptr;
 
-  //TODO: __cpp_lib_generic_unordered_lookup
-  std::string name = std::string(cname);
-  auto it=texCache.find(name);
-  if(it!=texCache.end())
-    return it->second.get();
-
-  auto tex = implLoadTextureUncached(cname, forceMips);
-  if(!tex.isEmpty()) {
-    std::unique_ptr<Texture2d> t{new Texture2d(std::move(tex))};
-    Texture2d* ret=t.get();
-    texCache[std::move(name)] = std::move(t);
+  return texCache.get(cname, [this,cname,forceMips]() {
+    std::unique_ptr<Texture2d> ret;
+    auto tex = implLoadTextureUncached(cname, forceMips);
+    if(!tex.isEmpty())
+      ret.reset(new Texture2d(std::move(tex)));
     return ret;
-    }
-  texCache[std::move(name)] = nullptr;
-  return nullptr;
+    });
   }
 
-Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMips) {
+const zenkit::VfsNode* Resources::implFindTexture(std::string_view name, bool& zTex) {
+  zTex = false;
   if(name.empty())
-    return Texture2d();
+    return nullptr;
 
   if(FileExt::hasExt(name,"TGA")) {
     auto nameAlt = std::string(name);
@@ -368,41 +449,137 @@ Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMi
     std::memcpy(&nameAlt[0]+nameAlt.size()-6, "-C.TEX", 6);
 
     if(const auto* entry = Resources::vdfsIndex().find(nameAlt)) {
-      zenkit::Texture tex;
+      zTex = true;
+      return entry;
+      }
+    }
 
-      auto reader = entry->open_read();
-      tex.load(reader.get());
+  return Resources::vdfsIndex().find(name);
+  }
+
+Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMips) {
+  bool zTex  = false;
+  auto entry = implFindTexture(name, zTex);
+  if(entry==nullptr)
+    return Texture2d();
 
-      if(tex.format() == zenkit::TextureFormat::DXT1 ||
-         tex.format() == zenkit::TextureFormat::DXT2 ||
-         tex.format() == zenkit::TextureFormat::DXT3 ||
-         tex.format() == zenkit::TextureFormat::DXT4 ||
-         tex.format() == zenkit::TextureFormat::DXT5) {
-        auto dds = zenkit::to_dds(tex);
-        auto ddsRead = zenkit::Read::from(dds);
+  if(zTex) {
+    auto ret = implLoadCachedTexture(texDiskCache.load(name, textureStamp(*entry)), forceMips);
+    if(!ret.isEmpty())
+      return ret;
+    }
 
-        return implLoadTextureUncached(name, *ddsRead, forceMips);
-        } else {
-        auto rgba = tex.as_rgba8(0);
+  Texture2d ret;
+  auto      view = vdfsMap.find(entry->name());
+  if(!view.empty() && !zTex) {
+    ret = implLoadPixmap(view.data(), view.size(), forceMips);
+    }
+  else if(!view.empty()) {
+    auto reader = zenkit::Read::from(reinterpret_cast<const std::byte*>(view.data()), view.size());
+    ret = implDecodeTexture(name, *reader, entry, forceMips);
+    }
+  else {
+    auto reader = entry->open_read();
+    ret = implDecodeTexture(name, *reader, zTex ? entry : nullptr, forceMips);
+    }
 
-        try {
-          Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
-          std::memcpy(pm.data(), rgba.data(), rgba.size());
-          return dev.texture(pm);
-          }
-        catch (...) {
-          }
-        }
+  if(ret.isEmpty() && zTex) {
+    // broken -C.TEX, try original file
+    if(auto orig = vdfsMap.find(name); !orig.empty())
+      return implLoadPixmap(orig.data(), orig.size(), forceMips);
+    if(auto* entry = Resources::vdfsIndex().find(name)) {
+      auto reader = entry->open_read();
+      return implLoadTextureUncached(name, *reader, forceMips);
       }
     }
+  return ret;
+  }
 
-  if(auto* entry = Resources::vdfsIndex().find(name)) {
-    auto reader = entry->open_read();
-    return implLoadTextureUncached(name, *reader, forceMips);
+uint64_t Resources::textureStamp(const zenkit::VfsNode& entry) {
+  return uint64_t(entry.time());
+  }
+
+Texture2d Resources::implDecodeTexture(std::string_view name, zenkit::Read& data, const zenkit::VfsNode* zTex, bool forceMips) {
+  if(zTex==nullptr)
+    return implLoadTextureUncached(name, data, forceMips);
+
+  zenkit::Texture tex;
+  tex.load(&data);
+
+  CachedTexture hdr;
+  hdr.w = tex.width();
+  hdr.h = tex.height();
+
+  if(tex.format() == zenkit::TextureFormat::DXT1 ||
+     tex.format() == zenkit::TextureFormat::DXT2 ||
+     tex.format() == zenkit::TextureFormat::DXT3 ||
+     tex.format() == zenkit::TextureFormat::DXT4 ||
+     tex.format() == zenkit::TextureFormat::DXT5) {
+    auto dds = zenkit::to_dds(tex);
+    hdr.kind = CachedTexture::K_Dds;
+    texDiskCache.store(name, textureStamp(*zTex), {{&hdr,sizeof(hdr)}, {dds.data(),dds.size()}});
+    return implLoadPixmap(reinterpret_cast<const uint8_t*>(dds.data()), dds.size(), forceMips);
+    }
+
+  // store complete mip chain, so cached loads don't need to generate mips
+  auto dds = mkRgbaDds(tex);
+  auto ret = implLoadPixmap(dds.data(), dds.size(), true);
+  if(!ret.isEmpty()) {
+    hdr.kind = CachedTexture::K_Dds;
+    texDiskCache.store(name, textureStamp(*zTex), {{&hdr,sizeof(hdr)}, {dds.data(),dds.size()}});
+    return ret;
+    }
+
+  auto rgba = tex.as_rgba8(0);
+  hdr.kind = CachedTexture::K_Rgba8;
+  texDiskCache.store(name, textureStamp(*zTex), {{&hdr,sizeof(hdr)}, {rgba.data(),rgba.size()}});
+  try {
+    Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
+    std::memcpy(pm.data(), rgba.data(), rgba.size());
+    return dev.texture(pm);
+    }
+  catch (...) {
     }
   return Texture2d();
   }
 
+Texture2d Resources::implLoadCachedTexture(const DiskCache::Blob& blob, bool forceMips) {
+  if(blob.size()<sizeof(CachedTexture))
+    return Texture2d();
+
+  CachedTexture hdr;
+  std::memcpy(&hdr, blob.data(), sizeof(hdr));
+  const uint8_t* pix  = blob.data() + sizeof(hdr);
+  const size_t   size = blob.size() - sizeof(hdr);
+
+  if(hdr.kind==CachedTexture::K_Dds)
+    return implLoadPixmap(pix, size, forceMips);
+
+  if(hdr.kind!=CachedTexture::K_Rgba8 || size<size_t(hdr.w)*size_t(hdr.h)*4)
+    return Texture2d();
+  try {
+    Tempest::Pixmap    pm(hdr.w, hdr.h, TextureFormat::RGBA8);
+    std::memcpy(pm.data(), pix, size_t(hdr.w)*size_t(hdr.h)*4);
+    return dev.texture(pm);
+    }
+  catch (...) {
+    }
+  return Texture2d();
+  }
+
+Texture2d Resources::implLoadPixmap(const uint8_t* data, size_t size, bool forceMips) {
+  try {
+    Tempest::MemReader rd(data, size);
+    Tempest::Pixmap    pm(rd);
+
+    const bool useMipmap = forceMips || (pm.mipCount()>1); // do not generate mips, if original texture has has none
+    return dev.texture(pm, useMipmap);
+    }
+  catch(...){
+    return Texture2d();
+    }
+  }
+
 Texture2d Resources::implLoadTextureUncached(std::string_view name, zenkit::Read& data, bool forceMips) {
   try {
     std::vector<uint8_t> raw;
@@ -410,12 +587,7 @@ Texture2d Resources::implLoadTextureUncached(std::string_view name, zenkit::Read
     raw.resize(data.tell());
     data.seek(0, zenkit::Whence::BEG);
     data.read(raw.data(), raw.size());
-
-    Tempest::MemReader rd((uint8_t*)raw.data(), raw.size());
-    Tempest::Pixmap    pm(rd);
-
-    const bool useMipmap = forceMips || (pm.mipCount()>1); // do not generate mips, if original texture has has none
-    return dev.texture(pm, useMipmap);
+    return implLoadPixmap(raw.data(), raw.size(), forceMips);
     }
   catch(...){
     return Texture2d();
@@ -426,17 +598,12 @@ ProtoMesh* Resources::implLoadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
 
-  auto cname = std::string(name);
-  auto it    = aniMeshCache.find(cname);
-  if(it!=aniMeshCache.end())
-    return it->second.get();
-
-  auto  t   = implLoadMeshMain(cname);
-  auto  ret = t.get();
-  aniMeshCache[cname] = std::move(t);
-  if(ret==nullptr)
-    Log::e("unable to load mesh \"",cname,"\"");
-  return ret;
+  return aniMeshCache.get(name, [this,name]() {
+    auto ret = implLoadMeshMain(std::string(name));
+    if(ret==nullptr)
+      Log::e("unable to load mesh \"",name,"\"");
+    return ret;
+    });
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
@@ -572,14 +739,13 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
   }
 
 PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
-  // TODO: reuse code from Resources::implLoadMeshMain
-  auto cname = std::string(name);
-  auto it    = emiMeshCache.find(cname);
-  if(it!=emiMeshCache.end())
-    return it->second.get();
-
-  auto& ret = emiMeshCache[cname];
+  return emiMeshCache.get(name, [this,name]() {
+    return implLoadEmiterMeshMain(std::string(name));
+    });
+  }
 
+std::unique_ptr<PfxEmitterMesh> Resources::implLoadEmiterMeshMain(std::string cname) {
+  // TODO: reuse code from Resources::implLoadMeshMain
   if(FileExt::hasExt(cname,"3DS")) {
     FileExt::exchangeExt(cname,"3DS","MRM");
 
@@ -593,12 +759,11 @@ PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
       return nullptr;
 
     PackedMesh packed(zmsh,PackedMesh::PK_Visual);
-    ret = std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(packed));
-    return ret.get();
+    return std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(packed));
     }
 
-  if(FileExt::hasExt(name,"MDM")) {
-    if(!hasFile(name))
+  if(FileExt::hasExt(cname,"MDM")) {
+    if(!hasFile(cname))
       return nullptr;
 
     const auto* entry = Resources::vdfsIndex().find(cname);
@@ -608,8 +773,7 @@ PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
     auto reader = entry->open_read();
     mdm.load(reader.get());
 
-    ret = std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(std::move(mdm)));
-    return ret.get();
+    return std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(std::move(mdm)));
     }
 
   return nullptr;
@@ -625,10 +789,12 @@ ProtoMesh* Resources::implDecalMesh(const zenkit::VisualDecal& decal) {
   if(key.mat.tex==nullptr)
     return nullptr;
 
-  auto it = decalMeshCache.find(key);
-  if(it!=decalMeshCache.end())
-    return it->second.get();
+  return decalMeshCache.get(key, [&key]() {
+    return implDecalMeshMain(key);
+    });
+  }
 
+std::unique_ptr<ProtoMesh> Resources::implDecalMeshMain(const DecalK& key) {
   Resources::Vertex vbo[8] = {
     {{-1.f, -1.f, 0.f},{0,0,-1},{0,1}, 0xFFFFFFFF},
     {{ 1.f, -1.f, 0.f},{0,0,-1},{1,1}, 0xFFFFFFFF},
@@ -651,11 +817,7 @@ ProtoMesh* Resources::implDecalMesh(const zenkit::VisualDecal& decal) {
     cibo = { 0,1,2, 0,2,3, 4,6,5, 4,7,6 }; else
     cibo = { 0,1,2, 0,2,3 };
 
-  std::unique_ptr<ProtoMesh> t{new ProtoMesh(key.mat, std::move(cvbo), std::move(cibo))};
-
-  auto ret = t.get();
-  decalMeshCache[key] = std::move(t);
-  return ret;
+  return std::unique_ptr<ProtoMesh>{new ProtoMesh(key.mat, std::move(cvbo), std::move(cibo))};
   }
 
 std::unique_ptr<Animation> Resources::implLoadAnimation(std::string name) {
@@ -698,10 +860,15 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
   if(name.empty())
     return Tempest::Sound();
 
-  if(!getFileData(name,fBuff))
-    return Tempest::Sound();
+  std::vector<uint8_t>     data;
+  std::span<const uint8_t> view = getFileView(name);
+  if(view.empty()) {
+    if(!getFileData(name,data))
+      return Tempest::Sound();
+    view = data;
+    }
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd(view.data(),view.size());
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -782,7 +949,6 @@ Texture2d Resources::loadTextureUncached(std::string_view name, bool forceMips)
   }
 
 const Texture2d* Resources::loadTexture(std::string_view name, bool forceMips) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadTexture(name,forceMips);
   }
 
@@ -806,25 +972,30 @@ const Texture2d* Resources::loadTexture(Tempest::Color color) {
   }
 
 const Texture2d *Resources::loadTexture(std::string_view name, int32_t iv, int32_t ic) {
-  if(name.size()>=128)
+  char buf[128]={};
+  if(!implVariantName(name,iv,ic,buf))
     return loadTexture(name);
+  return loadTexture(buf);
+  }
+
+bool Resources::implVariantName(std::string_view name, int32_t iv, int32_t ic, char (&out)[128]) {
+  if(name.size()>=128)
+    return false;
 
   char v[16]={};
   char c[16]={};
-  char buf1[128]={};
   char buf2[128]={};
 
   std::snprintf(v,sizeof(v),"V%d",iv);
   std::snprintf(c,sizeof(c),"C%d",ic);
-  std::snprintf(buf1,sizeof(buf1),"%.*s",int(name.size()),name.data());
+  std::snprintf(out,sizeof(out),"%.*s",int(name.size()),name.data());
 
-  emplaceTag(buf1,'V');
-  std::snprintf(buf2,sizeof(buf2),buf1,v);
+  emplaceTag(out,'V');
+  std::snprintf(buf2,sizeof(buf2),out,v);
 
   emplaceTag(buf2,'C');
-  std::snprintf(buf1,sizeof(buf1),buf2,c);
-
-  return loadTexture(buf1);
+  std::snprintf(out,sizeof(out),buf2,c);
+  return true;
   }
 
 std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name) {
@@ -860,6 +1031,19 @@ std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name)
     }
   }
 
+Resources::Future<Texture2d> Resources::loadTextureAsync(std::string_view name, float priority, bool forceMips) {
+  if(name.empty())
+    return Future<Texture2d>();
+  return Future<Texture2d>(inst->implStream(name,priority,forceMips));
+  }
+
+Resources::Future<Texture2d> Resources::loadTextureAsync(std::string_view name, int32_t iv, int32_t ic, float priority) {
+  char buf[128]={};
+  if(!implVariantName(name,iv,ic,buf))
+    return loadTextureAsync(name,priority);
+  return loadTextureAsync(buf,priority);
+  }
+
 Texture2d Resources::loadTexturePm(const Pixmap &pm) {
   if(pm.isEmpty()) {
     Pixmap p2(1,1,TextureFormat::R8);
@@ -876,14 +1060,12 @@ Material Resources::loadMaterial(const zenkit::Material& src, bool enableAlphaTe
 const ProtoMesh* Resources::loadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadMesh(name);
   }
 
 const PfxEmitterMesh* Resources::loadEmiterMesh(std::string_view name) {
   if(name.empty())
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadEmiterMesh(name);
   }
 
@@ -895,21 +1077,12 @@ const Skeleton* Resources::loadSkeleton(std::string_view name) {
   }
 
 const Animation* Resources::loadAnimation(std::string_view name) {
-  auto cname = std::string(name);
-
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  auto& cache = inst->animCache;
-  auto it=cache.find(cname);
-  if(it!=cache.end())
-    return it->second.get();
-  auto t       = inst->implLoadAnimation(cname);
-  auto ret     = t.get();
-  cache[cname] = std::move(t);
-  return ret;
+  return inst->animCache.get(name, [name]() {
+    return inst->implLoadAnimation(std::string(name));
+    });
   }
 
 Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadSoundBuffer(name);
   }
 
@@ -924,12 +1097,10 @@ DmSegment* Resources::loadMusicSegment(char const* name) {
   }
 
 const ProtoMesh* Resources::decalMesh(const zenkit::VisualDecal& decal) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implDecalMesh(decal);
   }
 
 const Resources::VobTree* Resources::loadVobBundle(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadVobBundle(name);
   }
 
@@ -987,11 +1158,12 @@ void Resources::recycle(Tempest::AccelerationStructure&& rtas) {
   }
 
 const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename) {
-  auto cname = std::string(filename);
-  auto i     = zenCache.find(cname);
-  if(i!=zenCache.end())
-    return i->second.get();
+  return zenCache.get(filename, [filename]() {
+    return implLoadVobBundleMain(std::string(filename));
+    });
+  }
 
+std::unique_ptr<Resources::VobTree> Resources::implLoadVobBundleMain(std::string cname) {
   std::vector<std::shared_ptr<zenkit::VirtualObject>> bundle;
   try {
     const auto* entry = Resources::vdfsIndex().find(cname);
@@ -1010,27 +1182,217 @@ const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename
     Log::e("unable to load Zen-file: \"",cname,"\"");
     }
 
-  auto ret = zenCache.insert(std::make_pair(filename,std::make_unique<VobTree>(std::move(bundle))));
-  return ret.first->second.get();
+  return std::make_unique<VobTree>(std::move(bundle));
   }
 
 const AttachBinder *Resources::bindMesh(const ProtoMesh &anim, const Skeleton &s) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-
   if(anim.submeshId.size()==0){
     static AttachBinder empty;
     return &empty;
     }
   BindK k = BindK(&s,&anim);
+  return inst->bindCache.get(k, [&s,&anim]() {
+    return std::unique_ptr<AttachBinder>(new AttachBinder(s,anim));
+    });
+  }
 
-  auto it = inst->bindCache.find(k);
-  if(it!=inst->bindCache.end())
-    return it->second.get();
+std::vector<Resources::CacheStat> Resources::cacheStats() {
+  auto mk = [](std::string_view name, const auto& cache) {
+    auto     st = cache.stats();
+    CacheStat ret;
+    ret.name      = name;
+    ret.hit       = st.hit;
+    ret.miss      = st.miss;
+    ret.contended = st.contended;
+    return ret;
+    };
+  return {
+    mk("texture",   inst->texCache),
+    mk("mesh",      inst->aniMeshCache),
+    mk("decal",     inst->decalMeshCache),
+    mk("animation", inst->animCache),
+    mk("bind",      inst->bindCache),
+    mk("emitter",   inst->emiMeshCache),
+    mk("zen",       inst->zenCache),
+    };
+  }
+
+std::shared_ptr<Resources::StreamJob> Resources::implStream(std::string_view name, float priority, bool forceMips) {
+  auto job = std::make_shared<StreamJob>();
+  job->name      = std::string(name);
+  job->priority  = priority;
+  job->forceMips = forceMips;
+  job->fallback  = &fallback;
+
+  // cache hit - no need to involve streaming threads
+  Texture2d* t = nullptr;
+  if(texCache.find(name,t)) {
+    job->result = t;
+    job->ready  = true;
+    return job;
+    }
+
+  {
+  std::lock_guard<std::mutex> g(streamSync);
+  auto it = streamPending.find(job->name);
+  if(it!=streamPending.end()) {
+    auto& pending = *it->second;
+    pending.forceMips = pending.forceMips || forceMips;
+    if(priority<pending.priority) {
+      pending.priority = priority;
+      // heap entries are immutable: push again, old entry will be skipped as stale
+      if(pending.queue!=nullptr)
+        pushStream(*pending.queue, it->second);
+      }
+    return it->second;
+    }
+  streamPending[job->name] = job;
+  pushStream(ioQueue, job);
+  }
+  streamCnd.notify_all();
+  return job;
+  }
+
+void Resources::implSetPriority(StreamJob& job, float priority) {
+  std::lock_guard<std::mutex> g(streamSync);
+  job.nextPriority = std::min(job.nextPriority, priority);
+  }
+
+void Resources::updateStreamPriorities() {
+  // camera has moved: reorder pending jobs by nearest user
+  auto& self = *inst;
+  std::lock_guard<std::mutex> g(self.streamSync);
+  for(auto& [name,job]:self.streamPending) {
+    const float p = std::exchange(job->nextPriority, std::numeric_limits<float>::infinity());
+    if(job->queue==nullptr || p==std::numeric_limits<float>::infinity())
+      continue;
+    // heap entries are immutable, each change leaves a stale one: ignore small changes
+    if(std::abs(p-job->priority) < std::max(100.f, job->priority*0.1f))
+      continue;
+    job->priority = p;
+    self.pushStream(*job->queue, job);
+    }
+  }
+
+void Resources::pushStream(StreamQueue& queue, std::shared_ptr<StreamJob> job) {
+  job->queue = &queue;
+  StreamEntry e;
+  e.priority = job->priority;
+  e.seq      = streamSeq++;
+  e.job      = std::move(job);
+  queue.push(std::move(e));
+  }
+
+std::shared_ptr<Resources::StreamJob> Resources::popStream(StreamQueue& queue) {
+  while(!queue.empty()) {
+    auto ret = queue.top().job;
+    bool old = (queue.top().priority!=ret->priority || ret->queue!=&queue);
+    queue.pop();
+    if(old)
+      continue;
+    ret->queue = nullptr;
+    return ret;
+    }
+  return nullptr;
+  }
 
-  std::unique_ptr<AttachBinder> ret(new AttachBinder(s,anim));
-  auto p = ret.get();
-  inst->bindCache[k] = std::move(ret);
-  return p;
+void Resources::streamIoMain() {
+  Workers::setThreadName("Resources: io");
+  while(true) {
+    std::shared_ptr<StreamJob> job;
+    {
+    std::unique_lock<std::mutex> lck(streamSync);
+    streamCnd.wait(lck,[this](){ return streamExit || !ioQueue.empty(); });
+    if(streamExit)
+      return;
+    job = popStream(ioQueue);
+    }
+    if(job==nullptr)
+      continue;
+
+    try {
+      bool zTex = false;
+      if(auto entry = implFindTexture(job->name, zTex)) {
+        if(zTex) {
+          job->zTex   = entry;
+          job->cached = texDiskCache.load(job->name, textureStamp(*entry));
+          }
+        if(job->cached.isEmpty())
+          job->view = vdfsMap.find(entry->name());
+        if(job->cached.isEmpty() && job->view.empty()) {
+          auto reader = entry->open_read();
+          reader->seek(0, zenkit::Whence::END);
+          job->raw.resize(reader->tell());
+          reader->seek(0, zenkit::Whence::BEG);
+          reader->read(job->raw.data(), job->raw.size());
+          }
+        }
+      }
+    catch(...) {
+      job->raw.clear();
+      }
+
+    {
+    std::lock_guard<std::mutex> g(streamSync);
+    pushStream(decodeQueue, std::move(job));
+    }
+    streamCnd.notify_all();
+    }
+  }
+
+void Resources::streamDecodeMain() {
+  Workers::setThreadName("Resources: decode");
+  while(true) {
+    std::shared_ptr<StreamJob> job;
+    {
+    std::unique_lock<std::mutex> lck(streamSync);
+    streamCnd.wait(lck,[this](){ return streamExit || !decodeQueue.empty(); });
+    if(streamExit)
+      return;
+    job = popStream(decodeQueue);
+    }
+    if(job==nullptr)
+      continue;
+
+    try {
+      streamDecode(*job);
+      }
+    catch(...) {
+      Log::e("unable to load \"",job->name,"\"");
+      }
+    job->ready.store(true);
+
+    std::lock_guard<std::mutex> g(streamSync);
+    auto it = streamPending.find(job->name);
+    if(it!=streamPending.end() && it->second==job)
+      streamPending.erase(it);
+    }
+  }
+
+void Resources::streamDecode(StreamJob& job) {
+  job.result = texCache.get(job.name, [this,&job]() {
+    Texture2d tex;
+    if(!job.cached.isEmpty())
+      tex = implLoadCachedTexture(job.cached, job.forceMips);
+    auto data = job.view.empty() ? std::span<const uint8_t>(job.raw) : job.view;
+    if(tex.isEmpty() && !data.empty() && job.zTex==nullptr) {
+      tex = implLoadPixmap(data.data(), data.size(), job.forceMips);
+      }
+    else if(tex.isEmpty() && !data.empty()) {
+      auto rd = zenkit::Read::from(reinterpret_cast<const std::byte*>(data.data()), data.size());
+      tex = implDecodeTexture(job.name, *rd, job.zTex, job.forceMips);
+      }
+    if(tex.isEmpty() && job.zTex!=nullptr)
+      tex = implLoadTextureUncached(job.name, job.forceMips);
+
+    std::unique_ptr<Texture2d> ret;
+    if(!tex.isEmpty())
+      ret.reset(new Texture2d(std::move(tex)));
+    return ret;
+    });
+  job.raw    = std::vector<uint8_t>();
+  job.view   = std::span<const uint8_t>();
+  job.cached = DiskCache::Blob();
   }
 
 Tempest::VertexBuffer<Resources::Vertex> Resources::sphere(int passCount, float R){
@@ -11,9 +11,18 @@
 #include <tuple>
 #include <string_view>
 #include <map>
+#include <queue>
+#include <limits>
+#include <span>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
 
 #include "graphics/material.h"
 #include "sound/soundfx.h"
+#include "utils/resourcecache.h"
+#include "utils/diskcache.h"
+#include "utils/vdfsmapping.h"
 
 struct DmSegment;
 struct DmLoader;
@@ -32,10 +41,32 @@ class PatternList;
 }
 
 class Resources final {
+  private:
+    struct StreamJob;
+
   public:
     explicit Resources(Tempest::Device& device);
     ~Resources();
 
+    // handle to resource, loaded by streaming threads
+    template<class T>
+    class Future final {
+      public:
+        Future() = default;
+        bool     isEmpty() const { return job==nullptr; }
+        bool     isReady() const;
+        // placeholder (fallbackTexture/nullptr) until loaded
+        const T* get() const;
+        // distance to camera of one of users; nearest one wins, applied by updateStreamPriorities
+        void     setPriority(float priority) const;
+
+      private:
+        explicit Future(std::shared_ptr<StreamJob> j):job(std::move(j)){}
+        std::shared_ptr<StreamJob> job;
+
+      friend class Resources;
+      };
+
     enum class FontType : uint8_t {
       Normal,
       Hi,
@@ -101,6 +132,9 @@ class Resources final {
     static const Tempest::Texture2d* loadTexture(std::string_view name, int32_t v, int32_t c);
     static       Tempest::Texture2d  loadTexturePm(const Tempest::Pixmap& pm);
     static auto                      loadTextureAnim(std::string_view name) -> std::vector<const Tempest::Texture2d*>;
+    static auto                      loadTextureAsync(std::string_view name, float priority, bool forceMips = false) -> Future<Tempest::Texture2d>;
+    static auto                      loadTextureAsync(std::string_view name, int32_t v, int32_t c, float priority) -> Future<Tempest::Texture2d>;
+    static void                      updateStreamPriorities();
     static       Material            loadMaterial(const zenkit::Material& src, bool enableAlphaTest);
 
     static const AttachBinder*       bindMesh       (const ProtoMesh& anim, const Skeleton& s);
@@ -145,6 +179,8 @@ class Resources final {
 
     static std::vector<uint8_t>      getFileData(std::string_view name);
     static bool                      getFileData(std::string_view name, std::vector<uint8_t>& dat);
+    // view into memory-mapped archive; empty for unknown, compressed or loose files
+    static std::span<const uint8_t>  getFileView(std::string_view name);
     static std::unique_ptr<zenkit::Read> getFileBuffer(std::string_view name);
     static auto                      openReader(std::string_view name, std::unique_ptr<zenkit::Read>& read) -> std::unique_ptr<zenkit::ReadArchive>;
     static bool                      hasFile    (std::string_view fname);
@@ -153,6 +189,14 @@ class Resources final {
 
     static const Tempest::IndexBuffer<uint16_t>&   cubeIbo();
 
+    struct CacheStat {
+      std::string_view name;
+      uint64_t         hit       = 0;
+      uint64_t         miss      = 0;
+      uint64_t         contended = 0;
+      };
+    static std::vector<CacheStat>    cacheStats();
+
   private:
     static Resources* inst;
 
@@ -176,7 +220,46 @@ class Resources final {
         }
       };
 
-    using TextureCache = std::unordered_map<std::string,std::unique_ptr<Tempest::Texture2d>>;
+
+    struct StreamEntry;
+    using  StreamQueue = std::priority_queue<StreamEntry>;
+
+    struct StreamJob {
+      std::string              name;
+      float                    priority  = 0; // distance to camera, lower is first
+      float                    nextPriority = std::numeric_limits<float>::infinity(); // min of setPriority calls, this frame
+      bool                     forceMips = false;
+      const zenkit::VfsNode*   zTex      = nullptr; // compiled -C.TEX entry
+      std::vector<uint8_t>     raw;
+      std::span<const uint8_t> view;
+      DiskCache::Blob          cached;
+      const void*              fallback  = nullptr;
+      std::atomic<const void*> result{nullptr};
+      std::atomic_bool         ready{false};
+      StreamQueue*             queue     = nullptr; // queue, that job is waiting in, guarded by streamSync
+      };
+
+    struct StreamEntry {
+      float                      priority = 0;
+      uint64_t                   seq      = 0;
+      std::shared_ptr<StreamJob> job;
+      bool operator < (const StreamEntry& other) const {
+        // std::priority_queue pops largest: nearest first, then oldest
+        return std::tie(priority,seq) > std::tie(other.priority,other.seq);
+        }
+      };
+
+    // header of transcoded texture in texDiskCache
+    struct CachedTexture {
+      enum Kind : uint32_t {
+        K_Dds   = 0,
+        K_Rgba8 = 1,
+        };
+      Kind     kind    = K_Dds;
+      uint32_t w       = 0;
+      uint32_t h       = 0;
+      uint32_t padding = 0;
+      };
 
     int64_t               vdfTimestamp(const std::u16string& name);
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
@@ -184,16 +267,33 @@ class Resources final {
     Tempest::Texture2d*   implLoadTexture(std::string_view cname, bool forceMips);
     Tempest::Texture2d    implLoadTextureUncached(std::string_view name, bool forceMips);
     Tempest::Texture2d    implLoadTextureUncached(std::string_view name, zenkit::Read& data, bool forceMips);
+    Tempest::Texture2d    implDecodeTexture(std::string_view name, zenkit::Read& data, const zenkit::VfsNode* zTex, bool forceMips);
+    Tempest::Texture2d    implLoadCachedTexture(const DiskCache::Blob& blob, bool forceMips);
+    Tempest::Texture2d    implLoadPixmap(const uint8_t* data, size_t size, bool forceMips);
+    static uint64_t       textureStamp(const zenkit::VfsNode& entry);
+    auto                  implFindTexture(std::string_view name, bool& zTex) -> const zenkit::VfsNode*;
     ProtoMesh*            implLoadMesh(std::string_view name);
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
     ProtoMesh*            implDecalMesh(const zenkit::VisualDecal& decal);
+    static std::unique_ptr<ProtoMesh> implDecalMeshMain(const DecalK& key);
     Tempest::Sound        implLoadSoundBuffer(std::string_view name);
     Dx8::PatternList      implLoadDxMusic(std::string_view name);
     DmSegment*            implLoadMusicSegment(char const* name);
     GthFont&              implLoadFont(std::string_view fname, FontType type, const float scale);
     PfxEmitterMesh*       implLoadEmiterMesh(std::string_view name);
+    std::unique_ptr<PfxEmitterMesh> implLoadEmiterMeshMain(std::string name);
     const VobTree*        implLoadVobBundle(std::string_view name);
+    static std::unique_ptr<VobTree> implLoadVobBundleMain(std::string name);
+
+    auto                  implStream(std::string_view name, float priority, bool forceMips) -> std::shared_ptr<StreamJob>;
+    void                  implSetPriority(StreamJob& job, float priority);
+    void                  streamIoMain();
+    void                  streamDecodeMain();
+    void                  streamDecode(StreamJob& job);
+    void                  pushStream(StreamQueue& queue, std::shared_ptr<StreamJob> job);
+    static auto           popStream(StreamQueue& queue) -> std::shared_ptr<StreamJob>;
+    static bool           implVariantName(std::string_view name, int32_t iv, int32_t ic, char (&out)[128]);
 
     Tempest::VertexBuffer<Vertex> sphere(int passCount, float R);
 
@@ -205,7 +305,10 @@ class Resources final {
 
     struct Hash {
       size_t operator()(const BindK& b) const {
-        return std::uintptr_t(std::get<0>(b));
+        // same skeleton is shared by many meshes
+        const size_t h0 = std::uintptr_t(std::get<0>(b));
+        const size_t h1 = std::uintptr_t(std::get<1>(b));
+        return h0 ^ (h1 + 0x9e3779b9 + (h0<<6) + (h0>>2));
         }
       size_t operator()(const DecalK& b) const {
         return std::uintptr_t(b.mat.tex);
@@ -231,8 +334,8 @@ class Resources final {
     std::unique_ptr<Dx8::DirectMusic> dxMusic;
     DmLoader*                         dmLoader = nullptr;
     zenkit::Vfs                       gothicAssets;
+    VdfsMapping                       vdfsMap;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::IndexBuffer<uint16_t>    cube;
 
     struct DeleteQueue {
@@ -246,16 +349,44 @@ class Resources final {
     DeleteQueue recycled[MaxFramesInFlight];
     uint8_t     recycledId = 0;
 
-    TextureCache                                                      texCache;
+    NamedResourceCache<Tempest::Texture2d>                            texCache;
+    DiskCache                                                         texDiskCache{"textures", 2};
     std::map<Tempest::Color,std::unique_ptr<Tempest::Texture2d>,Less> pixCache;
-    std::unordered_map<std::string,std::unique_ptr<ProtoMesh>>        aniMeshCache;
-    std::unordered_map<DecalK,std::unique_ptr<ProtoMesh>,Hash>        decalMeshCache;
-    std::unordered_map<std::string,std::unique_ptr<Skeleton>>         skeletonCache;
-    std::unordered_map<std::string,std::unique_ptr<Animation>>        animCache;
-    std::unordered_map<BindK,std::unique_ptr<AttachBinder>,Hash>      bindCache;
-    std::unordered_map<std::string,std::unique_ptr<PfxEmitterMesh>>   emiMeshCache;
-    std::unordered_map<std::string,std::unique_ptr<VobTree>>          zenCache;
+    NamedResourceCache<ProtoMesh>                                     aniMeshCache;
+    ResourceCache<DecalK,ProtoMesh,Hash>                              decalMeshCache;
+    NamedResourceCache<Animation>                                     animCache;
+    ResourceCache<BindK,AttachBinder,Hash>                            bindCache;
+    NamedResourceCache<PfxEmitterMesh>                                emiMeshCache;
+    NamedResourceCache<VobTree>                                       zenCache;
 
     std::recursive_mutex                                              syncFont;
     std::unordered_map<FontK,std::unique_ptr<GthFont>,Hash>           gothicFnt;
+
+    std::mutex                                                        streamSync;
+    std::condition_variable                                           streamCnd;
+    bool                                                              streamExit = false;
+    StreamQueue                                                       ioQueue, decodeQueue;
+    uint64_t                                                          streamSeq = 0;
+    std::unordered_map<std::string,std::shared_ptr<StreamJob>>        streamPending;
+    std::thread                                                       ioTh, decodeTh;
   };
+
+template<class T>
+bool Resources::Future<T>::isReady() const {
+  return job!=nullptr && job->ready.load();
+  }
+
+template<class T>
+void Resources::Future<T>::setPriority(float priority) const {
+  if(job!=nullptr && !job->ready.load())
+    inst->implSetPriority(*job,priority);
+  }
+
+template<class T>
+const T* Resources::Future<T>::get() const {
+  if(job==nullptr)
+    return nullptr;
+  if(!job->ready.load())
+    return static_cast<const T*>(job->fallback);
+  return static_cast<const T*>(job->result.load());
+  }
@@ -0,0 +1,135 @@
+#include "diskcache.h"
+
+#include <Tempest/Log>
+
+#include <fstream>
+#include <thread>
+#include <cstring>
+#include <cctype>
+
+#include "utils/string_frm.h"
+#include "commandline.h"
+
+using namespace Tempest;
+
+struct DiskCache::Header {
+  char     magic[4] = {'O','G','D','C'};
+  uint32_t version  = 0;
+  uint64_t stamp    = 0;
+  uint64_t dataSize = 0;
+  uint32_t keySize  = 0;
+  uint32_t padding  = 0;
+  };
+
+static size_t alignUp(size_t v, size_t a) {
+  return ((v+a-1)/a)*a;
+  }
+
+static uint64_t keyHash(std::string_view key) {
+  // FNV-1a, case-insensitive, same as vdfs lookup
+  uint64_t h = 14695981039346656037ull;
+  for(auto c:key) {
+    h ^= uint8_t(std::toupper(uint8_t(c)));
+    h *= 1099511628211ull;
+    }
+  return h;
+  }
+
+static bool keyEqual(std::string_view a, std::string_view b) {
+  if(a.size()!=b.size())
+    return false;
+  for(size_t i=0; i<a.size(); ++i)
+    if(std::toupper(uint8_t(a[i]))!=std::toupper(uint8_t(b[i])))
+      return false;
+  return true;
+  }
+
+DiskCache::DiskCache(std::string_view name, uint32_t version)
+  :version(version) {
+  // next to Gothic.ini/SystemPack.ini - working directory is not guaranteed to be the game folder
+  const auto sys = std::filesystem::path(CommandLine::inst().nestedPath({u"system"},Dir::FT_Dir));
+  dir = sys / "OpenGothic-cache" / string_frm(name,"-v",version).c_str();
+  }
+
+std::filesystem::path DiskCache::path(std::string_view key) const {
+  char buf[32] = {};
+  std::snprintf(buf, sizeof(buf), "%016llx.bin", static_cast<unsigned long long>(keyHash(key)));
+  return dir / buf;
+  }
+
+bool DiskCache::ensureDir() const {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  return !ec;
+  }
+
+DiskCache::Blob DiskCache::load(std::string_view key, uint64_t stamp) const {
+  Blob ret;
+  MappedFile file(path(key));
+  if(!file.isOpen() || file.size()<sizeof(Header))
+    return ret;
+
+  Header hdr;
+  std::memcpy(&hdr, file.data(), sizeof(hdr));
+  if(std::memcmp(hdr.magic, Header().magic, sizeof(hdr.magic))!=0 || hdr.version!=version || hdr.stamp!=stamp)
+    return ret;
+
+  const size_t offset = alignUp(sizeof(Header)+hdr.keySize, Alignment);
+  if(offset>file.size() || hdr.dataSize>file.size()-offset)
+    return ret;
+
+  auto fkey = std::string_view(reinterpret_cast<const char*>(file.data()+sizeof(Header)), hdr.keySize);
+  if(!keyEqual(fkey,key))
+    return ret; // hash collision
+
+  ret.ptr  = file.data()+offset;
+  ret.len  = size_t(hdr.dataSize);
+  ret.file = std::move(file);
+  return ret;
+  }
+
+bool DiskCache::store(std::string_view key, uint64_t stamp, std::initializer_list<Chunk> data) const {
+  if(!ensureDir())
+    return false;
+
+  Header hdr;
+  hdr.version = version;
+  hdr.stamp   = stamp;
+  hdr.keySize = uint32_t(key.size());
+  for(auto& i:data)
+    hdr.dataSize += alignUp(i.size, Alignment);
+
+  static const char zero[Alignment] = {};
+  const auto dst = path(key);
+  auto       tmp = dst;
+  tmp += string_frm(".", std::hash<std::thread::id>()(std::this_thread::get_id()), ".tmp").c_str();
+
+  {
+  std::ofstream fout(tmp, std::ios::binary | std::ios::trunc);
+  if(!fout)
+    return false;
+  fout.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  fout.write(key.data(), std::streamsize(key.size()));
+  fout.write(zero, std::streamsize(alignUp(sizeof(hdr)+key.size(),Alignment)-sizeof(hdr)-key.size()));
+  for(auto& i:data) {
+    fout.write(reinterpret_cast<const char*>(i.data), std::streamsize(i.size));
+    fout.write(zero, std::streamsize(alignUp(i.size,Alignment)-i.size));
+    }
+  if(!fout) {
+    fout.close();
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    Log::e("unable to write cache entry: \"", key, "\"");
+    return false;
+    }
+  }
+
+  // rename is atomic, so concurrent readers never observe partially written entry
+  std::error_code ec;
+  std::filesystem::rename(tmp, dst, ec);
+  if(ec) {
+    std::filesystem::remove(tmp, ec);
+    return false;
+    }
+  return true;
+  }
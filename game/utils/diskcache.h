@@ -0,0 +1,50 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+
+#include "mappedfile.h"
+
+// Persistent cache of data, derived from game assets (transcoded textures, packed meshes).
+// Each entry is one file, validated by key and stamp of the source; data is read via mmap.
+class DiskCache final {
+  public:
+    DiskCache(std::string_view name, uint32_t version);
+
+    class Blob final {
+      public:
+        Blob() = default;
+        bool           isEmpty() const { return ptr==nullptr; }
+        const uint8_t* data()    const { return ptr; }
+        size_t         size()    const { return len; }
+
+      private:
+        MappedFile     file;
+        const uint8_t* ptr = nullptr;
+        size_t         len = 0;
+
+      friend class DiskCache;
+      };
+
+    struct Chunk {
+      const void* data = nullptr;
+      size_t      size = 0;
+      };
+
+    Blob load (std::string_view key, uint64_t stamp) const;
+    bool store(std::string_view key, uint64_t stamp, std::initializer_list<Chunk> data) const;
+
+    // start of every blob chunk is aligned to this
+    static constexpr size_t Alignment = 16;
+
+  private:
+    struct Header;
+
+    auto path(std::string_view key) const -> std::filesystem::path;
+    bool ensureDir() const;
+
+    std::filesystem::path dir;
+    uint32_t              version = 0;
+  };
@@ -0,0 +1,91 @@
+#include "mappedfile.h"
+
+#include <Tempest/Platform>
+
+#include <utility>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef __WINDOWS__
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file==INVALID_HANDLE_VALUE)
+    return;
+
+  LARGE_INTEGER sz = {};
+  if(!GetFileSizeEx(file,&sz) || sz.QuadPart<=0) {
+    CloseHandle(file);
+    return;
+    }
+
+  HANDLE fmap = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if(fmap==nullptr)
+    return;
+
+  void* view = MapViewOfFile(fmap, FILE_MAP_READ, 0, 0, 0);
+  if(view==nullptr) {
+    CloseHandle(fmap);
+    return;
+    }
+
+  ptr    = reinterpret_cast<const uint8_t*>(view);
+  len    = size_t(sz.QuadPart);
+  handle = fmap;
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd<0)
+    return;
+
+  struct stat st = {};
+  if(::fstat(fd,&st)!=0 || st.st_size<=0) {
+    ::close(fd);
+    return;
+    }
+
+  void* view = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(view==MAP_FAILED)
+    return;
+
+  ptr = reinterpret_cast<const uint8_t*>(view);
+  len = size_t(st.st_size);
+#endif
+  }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  :ptr(std::exchange(other.ptr,nullptr)), len(std::exchange(other.len,0)), handle(std::exchange(other.handle,nullptr)) {
+  }
+
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept {
+  std::swap(ptr,    other.ptr);
+  std::swap(len,    other.len);
+  std::swap(handle, other.handle);
+  return *this;
+  }
+
+MappedFile::~MappedFile() {
+  close();
+  }
+
+void MappedFile::close() {
+  if(ptr==nullptr)
+    return;
+#ifdef __WINDOWS__
+  UnmapViewOfFile(ptr);
+  CloseHandle(reinterpret_cast<HANDLE>(handle));
+#else
+  ::munmap(const_cast<uint8_t*>(ptr), len);
+#endif
+  ptr    = nullptr;
+  len    = 0;
+  handle = nullptr;
+  }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+// read-only memory mapping of a whole file
+class MappedFile final {
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator = (MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    bool           isOpen() const { return ptr!=nullptr; }
+    const uint8_t* data()   const { return ptr; }
+    size_t         size()   const { return len; }
+
+  private:
+    void           close();
+
+    const uint8_t* ptr    = nullptr;
+    size_t         len    = 0;
+    void*          handle = nullptr; // file-mapping object on windows
+  };
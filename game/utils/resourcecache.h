@@ -0,0 +1,153 @@
+#pragma once
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+
+// Thread-safe cache of immutable resources:
+//  * sharded reader-writer locks, so hits from different threads do not serialize
+//  * heterogeneous lookup, std::string_view doesn't need to be copied on hit
+//  * miss de-duplication - two threads asking for same resource do load it once
+template<class Key, class T, class Hash = std::hash<Key>, class Eq = std::equal_to<>>
+class ResourceCache final {
+  public:
+    struct Stat {
+      uint64_t hit       = 0;
+      uint64_t miss      = 0;
+      uint64_t contended = 0; // lock was not acquired on first try
+      };
+
+    ResourceCache() = default;
+    ResourceCache(const ResourceCache&) = delete;
+
+    // true, if resource is loaded; nullptr is legit value for missing resource
+    template<class K>
+    bool find(const K& key, T*& ret) {
+      auto& sh = shard(key);
+      auto  l  = lockShared(sh);
+      auto  it = mapFind(sh.data, key);
+      if(it==sh.data.end() || !it->second->ready.load())
+        return false;
+      ret = it->second->value.get();
+      return true;
+      }
+
+    // returns cached value or loads it with `loader`, that return std::unique_ptr<T>
+    template<class K, class F>
+    T* get(const K& key, F&& loader) {
+      auto& sh   = shard(key);
+      Slot* slot = nullptr;
+      {
+        auto l  = lockShared(sh);
+        auto it = mapFind(sh.data, key);
+        if(it!=sh.data.end()) {
+          slot = it->second.get();
+          if(slot->ready.load()) {
+            stat.hit.fetch_add(1, std::memory_order_relaxed);
+            return slot->value.get();
+            }
+          }
+      }
+
+      if(slot==nullptr) {
+        auto l  = lockUnique(sh);
+        auto it = mapFind(sh.data, key);
+        if(it==sh.data.end())
+          it = sh.data.emplace(Key(key), std::make_unique<Slot>()).first;
+        slot = it->second.get();
+      }
+
+      stat.miss.fetch_add(1, std::memory_order_relaxed);
+      std::call_once(slot->once, [slot, &loader]() {
+        slot->value = loader();
+        slot->ready.store(true);
+        });
+      return slot->value.get();
+      }
+
+    Stat stats() const {
+      Stat ret;
+      ret.hit       = stat.hit.load();
+      ret.miss      = stat.miss.load();
+      ret.contended = stat.contended.load();
+      return ret;
+      }
+
+  private:
+    enum { ShardCount = 16 };
+
+    struct Slot {
+      std::once_flag     once;
+      std::atomic_bool   ready{false};
+      std::unique_ptr<T> value;
+      };
+
+    using Map = std::unordered_map<Key,std::unique_ptr<Slot>,Hash,Eq>;
+
+    struct alignas(64) Shard {
+      std::shared_mutex sync;
+      Map               data;
+      };
+
+    struct {
+      std::atomic<uint64_t> hit{0};
+      std::atomic<uint64_t> miss{0};
+      std::atomic<uint64_t> contended{0};
+      } stat;
+
+    Shard shards[ShardCount];
+
+    template<class K>
+    Shard& shard(const K& key) {
+      // pointer-based hashes have zero low bits: mix all of them, before picking shard
+      uint64_t h = uint64_t(Hash()(key));
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33;
+      return shards[h%ShardCount];
+      }
+
+    template<class K>
+    static auto mapFind(Map& m, const K& key) {
+#if defined(__cpp_lib_generic_unordered_lookup)
+      return m.find(key);
+#else
+      if constexpr(std::is_same_v<K,Key>)
+        return m.find(key); else
+        return m.find(Key(key));
+#endif
+      }
+
+    std::shared_lock<std::shared_mutex> lockShared(Shard& sh) {
+      std::shared_lock<std::shared_mutex> l(sh.sync, std::try_to_lock);
+      if(!l.owns_lock()) {
+        stat.contended.fetch_add(1, std::memory_order_relaxed);
+        l.lock();
+        }
+      return l;
+      }
+
+    std::unique_lock<std::shared_mutex> lockUnique(Shard& sh) {
+      std::unique_lock<std::shared_mutex> l(sh.sync, std::try_to_lock);
+      if(!l.owns_lock()) {
+        stat.contended.fetch_add(1, std::memory_order_relaxed);
+        l.lock();
+        }
+      return l;
+      }
+  };
+
+struct ResourceNameHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+  size_t operator()(const std::string& s) const { return std::hash<std::string_view>()(s); }
+  };
+
+template<class T>
+using NamedResourceCache = ResourceCache<std::string,T,ResourceNameHash,std::equal_to<>>;
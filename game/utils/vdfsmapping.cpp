@@ -0,0 +1,116 @@
+#include "vdfsmapping.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace {
+enum : uint32_t {
+  VDF_COMMENT_LENGTH   = 256,
+  VDF_SIGNATURE_LENGTH = 16,
+  VDF_NAME_LENGTH      = 64,
+  VDF_ENTRY_DIR        = 0x80000000,
+  };
+
+struct VdfHeader {
+  char     comment  [VDF_COMMENT_LENGTH];
+  char     signature[VDF_SIGNATURE_LENGTH];
+  uint32_t entryCount;
+  uint32_t fileCount;
+  uint32_t timestamp;
+  uint32_t size;
+  uint32_t catalogOffset;
+  uint32_t version;
+  };
+
+struct VdfEntry {
+  char     name[VDF_NAME_LENGTH];
+  uint32_t offset;
+  uint32_t size;
+  uint32_t type;
+  uint32_t attributes;
+  };
+}
+
+static const char vdfSignatureG1[] = "PSVDSC_V2.00\r\n\r\n";
+static const char vdfSignatureG2[] = "PSVDSC_V2.00\n\r\n\r";
+
+static size_t upperName(char* dst, size_t maxSz, std::string_view name) {
+  // vdf names are upper-case, padded with spaces
+  while(!name.empty() && (name.back()==' ' || name.back()=='\0'))
+    name.remove_suffix(1);
+  if(name.size()>maxSz)
+    return size_t(-1);
+  for(size_t i=0; i<name.size(); ++i)
+    dst[i] = char(std::toupper(uint8_t(name[i])));
+  return name.size();
+  }
+
+bool VdfsMapping::mount(const std::filesystem::path& path, int64_t time) {
+  if(!implMount(path,time)) {
+    // unknown content may override any older entry
+    unmappedTime = std::max(unmappedTime, time);
+    return false;
+    }
+  return true;
+  }
+
+bool VdfsMapping::implMount(const std::filesystem::path& path, int64_t time) {
+  auto file = std::make_unique<MappedFile>(path);
+  if(!file->isOpen() || file->size()<sizeof(VdfHeader))
+    return false;
+
+  VdfHeader hdr = {};
+  std::memcpy(&hdr, file->data(), sizeof(hdr));
+  // other signatures are used by compressed archives
+  if(std::memcmp(hdr.signature, vdfSignatureG1, VDF_SIGNATURE_LENGTH)!=0 &&
+     std::memcmp(hdr.signature, vdfSignatureG2, VDF_SIGNATURE_LENGTH)!=0)
+    return false;
+
+  const size_t catalogEnd = size_t(hdr.catalogOffset) + size_t(hdr.entryCount)*sizeof(VdfEntry);
+  if(catalogEnd>file->size())
+    return false;
+
+  for(uint32_t i=0; i<hdr.entryCount; ++i) {
+    VdfEntry e = {};
+    std::memcpy(&e, file->data() + hdr.catalogOffset + i*sizeof(VdfEntry), sizeof(e));
+    if((e.type & VDF_ENTRY_DIR)!=0)
+      continue;
+    if(size_t(e.offset)+size_t(e.size)>file->size())
+      continue;
+
+    char   buf[VDF_NAME_LENGTH] = {};
+    size_t len = upperName(buf, sizeof(buf), std::string_view(e.name, VDF_NAME_LENGTH));
+    if(len==0 || len==size_t(-1))
+      continue;
+
+    Entry ent;
+    ent.data = std::span<const uint8_t>(file->data()+e.offset, e.size);
+    ent.time = time;
+
+    auto it = index.find(std::string(buf,len));
+    if(it==index.end())
+      index.emplace(std::string(buf,len), ent);
+    else if(it->second.time<time)
+      it->second = ent;
+    }
+
+  archives.emplace_back(std::move(file));
+  return true;
+  }
+
+std::span<const uint8_t> VdfsMapping::find(std::string_view name) const {
+  char   buf[VDF_NAME_LENGTH] = {};
+  size_t len = upperName(buf, sizeof(buf), name);
+  if(len==size_t(-1))
+    return {};
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+  auto it = index.find(std::string_view(buf,len));
+#else
+  auto it = index.find(std::string(buf,len));
+#endif
+  if(it==index.end() || it->second.time<unmappedTime)
+    return {};
+  return it->second.data;
+  }
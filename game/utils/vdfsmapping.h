@@ -0,0 +1,40 @@
+#pragma once
+
+#include <unordered_map>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdint>
+
+#include "mappedfile.h"
+
+// Memory-mapped VDF archives and flat index of their uncompressed entries.
+// Entries are resolved the same way, as zenkit::Vfs does it with VfsOverwriteBehavior::OLDER
+class VdfsMapping final {
+  public:
+    VdfsMapping() = default;
+    VdfsMapping(const VdfsMapping&) = delete;
+
+    bool mount(const std::filesystem::path& path, int64_t time);
+    // empty, if file is not known or not stored as plain data
+    auto find(std::string_view name) const -> std::span<const uint8_t>;
+
+  private:
+    struct Entry {
+      std::span<const uint8_t> data;
+      int64_t                  time = 0;
+      };
+
+    struct Hash {
+      using is_transparent = void;
+      size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+      };
+
+    bool implMount(const std::filesystem::path& path, int64_t time);
+
+    std::vector<std::unique_ptr<MappedFile>>                        archives;
+    std::unordered_map<std::string,Entry,Hash,std::equal_to<>>      index;
+    int64_t                                                         unmappedTime = INT64_MIN;
+  };
@@ -4,6 +4,9 @@
 #include <Tempest/Platform>
 #include <Tempest/Log>
 
+#include <chrono>
+#include <cstdint>
+
 #if defined(__WINDOWS__)
 #include <windows.h>
 #include <processthreadsapi.h>
@@ -13,6 +16,15 @@
 #include <pthread.h>
 #endif
 
+#if defined(__LINUX__)
+#include <sched.h>
+#include <cstdio>
+#endif
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #if defined(_MSC_VER)
 void Workers::setThreadName(const char* threadName) {
   const DWORD MS_VC_EXCEPTION = 0x406D1388;
@@ -68,24 +80,175 @@ void Workers::setThreadName(const char* threadName) { (void)threadName; }
 
 using namespace Tempest;
 
-const size_t Workers::taskPerThread = 128;
-const size_t Workers::taskPerStep   = 16;
+const uint64_t Workers::minTaskNs = 25'000; // less work per thread is not worth to wakeup it
+const uint64_t Workers::stepNs    = 10'000;
+const uint32_t Workers::spinCount = 2048;
+
+static thread_local size_t workerId = size_t(-1);
+
+std::mutex                      Workers::callSiteSync;
+std::vector<Workers::CallSite*> Workers::callSiteList;
+Workers::CallSiteMap            Workers::callSiteMap;
+std::vector<std::unique_ptr<Workers::CallSiteRef>> Workers::callSiteRefList;
+std::atomic<const Workers::CallSiteRef*>           Workers::callSiteRef[Workers::CallSiteSlots] = {};
+
+static uint32_t setupThreads = 0;
+static bool     setupPinning = false;
+
+static void cpuRelax() {
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+  _mm_pause();
+#elif defined(__aarch64__) && defined(__GNUC__)
+  asm volatile("yield");
+#else
+  std::this_thread::yield();
+#endif
+  }
+
+#if defined(__LINUX__)
+static bool readSysInt(uint32_t cpu, const char* name, int& ret) {
+  char path[128] = {};
+  std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/%s", unsigned(cpu), name);
+  FILE* f = std::fopen(path,"r");
+  if(f==nullptr)
+    return false;
+  const bool ok = std::fscanf(f,"%d",&ret)==1;
+  std::fclose(f);
+  return ok;
+  }
+
+static std::vector<int32_t> cpuOrder() {
+  // one logical cpu per physical core first, SMT siblings at the end of the list
+  std::vector<int32_t> primary, secondary;
+  std::vector<std::pair<int,int>> cores;
+
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if(sched_getaffinity(0, sizeof(allowed), &allowed)!=0)
+    return {};
+
+  for(uint32_t i=0; i<CPU_SETSIZE; ++i) {
+    if(!CPU_ISSET(i, &allowed))
+      continue;
+    int core = 0, package = 0;
+    if(!readSysInt(i,"core_id",core) || !readSysInt(i,"physical_package_id",package)) {
+      primary.push_back(int32_t(i));
+      continue;
+      }
+    auto id = std::make_pair(package,core);
+    if(std::find(cores.begin(),cores.end(),id)!=cores.end()) {
+      secondary.push_back(int32_t(i));
+      continue;
+      }
+    cores.push_back(id);
+    primary.push_back(int32_t(i));
+    }
+  primary.insert(primary.end(),secondary.begin(),secondary.end());
+  return primary;
+  }
+
+static void pinThread(int32_t cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(size_t(cpu), &set);
+  if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set)!=0)
+    Log::e("Workers: unable to set thread affinity to cpu ", cpu);
+  }
+#else
+static std::vector<int32_t> cpuOrder() {
+  return {};
+  }
+
+static void pinThread(int32_t) {
+  }
+#endif
+
+Workers::CallSite::CallSite(const std::source_location& loc)
+  :file(loc.file_name()), line(uint32_t(loc.line())) {
+  }
+
+Workers::CallSite& Workers::callSite(const std::source_location& loc) {
+  // hot path: no lock, file_name is a literal - compare by pointer
+  const char*    file = loc.file_name();
+  const uint32_t line = uint32_t(loc.line());
+  const size_t   hash = size_t((reinterpret_cast<uintptr_t>(file) >> 3) ^ (uintptr_t(line)*0x9E3779B9u));
+  for(size_t i=0; i<CallSiteSlots; ++i) {
+    auto r = callSiteRef[(hash+i)%CallSiteSlots].load(std::memory_order_acquire);
+    if(r==nullptr)
+      break;
+    if(r->file==file && r->line==line)
+      return *r->site;
+    }
+  return implRegisterCallSite(loc,hash);
+  }
+
+Workers::CallSite& Workers::implRegisterCallSite(const std::source_location& loc, size_t hash) {
+  // keyed by file:line - same functor type may be used from many places, with very different cost
+  // literal of same file may differ between translation units: map by content, then publish pointer-key
+  const CallSiteKey key = {loc.file_name(), uint32_t(loc.line())};
+
+  std::lock_guard<std::mutex> guard(callSiteSync);
+  auto& site = callSiteMap[key];
+  if(site==nullptr) {
+    site.reset(new CallSite(loc));
+    callSiteList.push_back(site.get());
+    }
+
+  for(size_t i=0; i<CallSiteSlots; ++i) {
+    auto& slot = callSiteRef[(hash+i)%CallSiteSlots];
+    auto  r    = slot.load(std::memory_order_relaxed);
+    if(r!=nullptr) {
+      if(r->file==loc.file_name() && r->line==key.line)
+        break;
+      continue;
+      }
+    auto ref = std::make_unique<CallSiteRef>();
+    ref->file = loc.file_name();
+    ref->line = key.line;
+    ref->site = site.get();
+    slot.store(ref.get(), std::memory_order_release);
+    callSiteRefList.push_back(std::move(ref));
+    break;
+    }
+  // table is full: site still works, via this locked path
+  return *site;
+  }
+
+bool Workers::Task::isDone() const {
+  return job==nullptr || job->done.load();
+  }
 
 Workers::Workers() {
-  size_t id=0;
-  for(auto& i:th) {
-    i = std::thread([this,id]() noexcept {
-      threadFunc(id);
+  size_t count = setupThreads;
+  if(count==0) {
+    // main thread also do tasks
+    count = std::thread::hardware_concurrency();
+    count = count>1 ? count-1 : 1;
+    }
+
+  std::vector<int32_t> cpu;
+  if(setupPinning)
+    cpu = cpuOrder();
+
+  queueCount = count+1;
+  queue.reset(new Queue[queueCount]);
+  th.resize(count);
+  for(size_t id=0; id<th.size(); ++id) {
+    // cpu[0] is left for the main thread
+    const int32_t c = cpu.size()>1 ? cpu[(id+1)%cpu.size()] : -1;
+    th[id] = std::thread([this,id,c]() noexcept {
+      threadFunc(id,c);
       });
-    ++id;
     }
+  Log::i("Workers: ", th.size(), " threads", cpu.empty() ? "" : " (pinned)");
   }
 
 Workers::~Workers() {
-  running  = false;
-  workSet  = nullptr;
-  workSize = MAX_THREADS;
-  execWork(minWorkSize<void,void>());
+  {
+  std::unique_lock<std::mutex> lck(sync);
+  running.store(false);
+  }
+  workWait.notify_all();
   for(auto& i:th)
     i.join();
   }
@@ -95,113 +258,234 @@ Workers &Workers::inst() {
   return w;
   }
 
-uint8_t Workers::maxThreads() {
-  int32_t th = int32_t(std::thread::hardware_concurrency());
-  if(th<=0)
-    th = 1;
-  if(th>MAX_THREADS)
-    return MAX_THREADS;
-  return uint8_t(th);
+void Workers::setup(uint32_t threads, bool pinThreads) {
+  setupThreads = threads;
+  setupPinning = pinThreads;
   }
 
-void Workers::threadFunc(size_t id) {
+uint32_t Workers::maxThreads() {
+  return uint32_t(inst().th.size());
+  }
+
+std::vector<Workers::CallSiteStat> Workers::callSiteStats() {
+  std::lock_guard<std::mutex> guard(callSiteSync);
+  std::vector<CallSiteStat> ret(callSiteList.size());
+  for(size_t i=0; i<callSiteList.size(); ++i) {
+    auto& s = *callSiteList[i];
+    auto& r = ret[i];
+    r.file      = s.file;
+    r.line      = s.line;
+    r.calls     = s.calls.load();
+    r.nsPerItem = s.nsPerItem.load();
+    r.step      = s.step.load();
+    r.threads   = s.threads.load();
+    const size_t sep = r.file.find_last_of("/\\");
+    if(sep!=std::string_view::npos)
+      r.file = r.file.substr(sep+1);
+    }
+  return ret;
+  }
+
+Workers::Task Workers::spawn(std::function<void()> fn, std::initializer_list<Task> deps) {
+  auto job = std::make_shared<Job>();
+  job->func = std::move(fn);
+  for(auto& d:deps) {
+    if(d.job==nullptr)
+      continue;
+    std::lock_guard<std::mutex> guard(d.job->sync);
+    if(d.job->done.load())
+      continue;
+    job->pending.fetch_add(1);
+    d.job->next.push_back(job);
+    }
+
+  Task ret(job);
+  if(job->pending.fetch_sub(1)==1)
+    inst().push(std::move(job));
+  return ret;
+  }
+
+void Workers::wait(const Task& t) {
+  auto& w = inst();
+  for(uint32_t spin=0; !t.isDone(); ) {
+    if(auto job = w.pop()) {
+      w.exec(std::move(job));
+      spin = 0;
+      continue;
+      }
+    if(spin<spinCount) {
+      cpuRelax();
+      ++spin;
+      continue;
+      }
+    // nothing to help with - park until some job is done
+    std::unique_lock<std::mutex> lck(w.sync);
+    w.waiters.fetch_add(1);
+    w.doneWait.wait(lck, [&w,&t]() { return t.isDone() || w.queued.load()>0; });
+    w.waiters.fetch_sub(1);
+    spin = 0;
+    }
+  }
+
+void Workers::threadFunc(size_t id, int32_t cpu) {
   {
   string_frm tname("Workers [",int(id),"]");
   setThreadName(tname.c_str());
   }
+  workerId = id;
+  if(cpu>=0)
+    pinThread(cpu);
+
+  for(uint32_t spin=0; ; ) {
+    if(auto job = pop()) {
+      exec(std::move(job));
+      spin = 0;
+      continue;
+      }
+    if(spin<spinCount && running.load()) {
+      cpuRelax();
+      ++spin;
+      continue;
+      }
 
-  while(true) {
-    {
     std::unique_lock<std::mutex> lck(sync);
-    workWait.wait(lck, [this]() { return workTbd>0; });
-    --workTbd;
+    parked.fetch_add(1);
+    workWait.wait(lck, [this]() { return queued.load()>0 || !running.load(); });
+    parked.fetch_sub(1);
+    if(!running.load() && queued.load()<=0)
+      return;
+    spin = 0;
     }
+  }
 
-    if(!running) {
-      taskDone.fetch_add(1);
-      return;
-      }
+void Workers::push(std::shared_ptr<Job> job) {
+  auto& q = queue[std::min(workerId, queueCount-1)];
+  {
+  std::lock_guard<std::mutex> guard(q.sync);
+  q.jobs.push_back(std::move(job));
+  }
+  queued.fetch_add(1);
+  if(parked.load()==0 && waiters.load()==0)
+    return;
+  {
+  std::lock_guard<std::mutex> guard(sync);
+  }
+  workWait.notify_one();
+  doneWait.notify_all();
+  }
 
-    if(workSet==nullptr) {
-      auto idx = progressIt.fetch_add(1);
-      workFunc(workSet+idx, 1);
-      } else {
-      taskLoop();
+std::shared_ptr<Workers::Job> Workers::pop() {
+  if(queued.load()<=0)
+    return nullptr;
+
+  const size_t self = std::min(workerId, queueCount-1);
+  if(self+1<queueCount) {
+    // own queue - LIFO, to keep nested jobs hot in cache
+    auto& q = queue[self];
+    std::lock_guard<std::mutex> guard(q.sync);
+    if(!q.jobs.empty()) {
+      auto ret = std::move(q.jobs.back());
+      q.jobs.pop_back();
+      queued.fetch_sub(1);
+      return ret;
       }
+    }
 
-    taskDone.fetch_add(1);
-    // if(size_t(taskDone.fetch_add(1)+1)==taskCount)
-    //   std::this_thread::yield();
+  // steal - FIFO, oldest (usually largest) jobs first
+  for(size_t i=0; i<queueCount; ++i) {
+    auto& q = queue[(self+1+i)%queueCount];
+    std::lock_guard<std::mutex> guard(q.sync);
+    if(q.jobs.empty())
+      continue;
+    auto ret = std::move(q.jobs.front());
+    q.jobs.pop_front();
+    queued.fetch_sub(1);
+    return ret;
     }
+  return nullptr;
   }
 
-uint32_t Workers::taskLoop() {
-  uint32_t count = 0;
-  while(true) {
-    size_t b = size_t(progressIt.fetch_add(taskPerStep));
-    size_t e = std::min(b+taskPerStep, workSize);
-    if(e<=b)
-      break;
+void Workers::exec(std::shared_ptr<Job> job) {
+  job->func();
+  job->func = nullptr;
 
-    void* d = workSet + b*workEltSize;
-    workFunc(d,e-b);
-    count += uint32_t(e-b);
+  std::vector<std::shared_ptr<Job>> next;
+  {
+  std::lock_guard<std::mutex> guard(job->sync);
+  job->done.store(true);
+  next = std::move(job->next);
+  }
+
+  for(auto& i:next)
+    if(i->pending.fetch_sub(1)==1)
+      push(std::move(i));
+
+  if(waiters.load()>0) {
+    {
+    std::lock_guard<std::mutex> guard(sync);
+    }
+    doneWait.notify_all();
     }
-  return count;
   }
 
-void Workers::execWork(uint32_t& minElts) {
+void Workers::execWork(size_t workSize, CallSite& site, const void* ctx, RangeFn fn) {
+  using namespace std::chrono;
   if(workSize==0)
     return;
 
-  if(workSet!=nullptr) {
-    const auto maxTheads = maxThreads();
-    taskCount = uint32_t((workSize+taskPerThread-1)/taskPerThread);
-    taskCount--; // main thread also do tasks
-    if(taskCount>maxTheads)
-      taskCount = maxTheads;
-    if(taskCount<=0)
-      taskCount = 1;
-    } else {
-    taskCount = uint32_t(workSize);
+  // unknown cost - assume heavy work, so one-shot loops (world load) are never serialized
+  const float  ns      = site.nsPerItem.load();
+  const float  cost    = ns*float(workSize);
+  size_t       threads = 1;
+  if(ns<=0) {
+    threads = std::min(size_t(maxThreads())+1, workSize);
     }
-
-  if(running && taskCount==1) {
-    workFunc(workSet, workSize);
-    return;
+  else if(cost>=float(2*minTaskNs)) {
+    threads = size_t(cost/float(minTaskNs));
+    threads = std::min(threads, size_t(maxThreads())+1);
+    threads = std::min(threads, workSize);
     }
 
-  minElts = std::max<uint32_t>(minElts, taskPerThread);
-
-  if(workSet!=nullptr && workSize<=minElts && true) {
-    workFunc(workSet, workSize);
-    if(minElts > workSize*2)
-      minElts = 0;
-    return;
+  size_t step = workSize;
+  if(threads>1) {
+    // few batches per thread, to balance uneven items
+    const size_t maxStep = std::max<size_t>(workSize/(threads*4), 1);
+    step = ns>0 ? size_t(float(stepNs)/ns) : maxStep;
+    step = std::clamp<size_t>(step, 1, maxStep);
     }
 
-  progressIt.store(0);
-  taskDone.store(0);
-
-  {
-  std::unique_lock<std::mutex> lck(sync);
-  workTbd = int32_t(taskCount);
-  }
-  workWait.notify_all();
+  site.calls.fetch_add(1, std::memory_order_relaxed);
+  site.step   .store(uint32_t(step),    std::memory_order_relaxed);
+  site.threads.store(uint32_t(threads), std::memory_order_relaxed);
 
-  uint32_t cnt = 0;
-  if(workSet==nullptr) {
-    std::this_thread::yield();
+  std::atomic<uint64_t> busyNs{0};
+  if(threads<=1) {
+    auto t0 = steady_clock::now();
+    fn(ctx, 0, workSize);
+    busyNs = uint64_t(duration_cast<nanoseconds>(steady_clock::now()-t0).count());
     } else {
-    cnt = taskLoop(); (void)cnt;
-    }
+    std::atomic_size_t progressIt{0};
+    auto taskLoop = [&progressIt,&busyNs,workSize,step,ctx,fn]() {
+      auto t0 = steady_clock::now();
+      while(true) {
+        size_t b = progressIt.fetch_add(step);
+        size_t e = std::min(b+step, workSize);
+        if(e<=b)
+          break;
+        fn(ctx, b, e);
+        }
+      busyNs.fetch_add(uint64_t(duration_cast<nanoseconds>(steady_clock::now()-t0).count()));
+      };
 
-  while(true) {
-    int expect = int(taskCount);
-    if(taskDone.load()==expect) {
-      taskDone.store(0);
-      break;
-      }
-    std::this_thread::yield();
+    std::vector<Task> tasks(threads-1); // main thread also do tasks
+    for(auto& t:tasks)
+      t = spawn(taskLoop);
+    taskLoop();
+    for(auto& t:tasks)
+      wait(t);
     }
+
+  // exponential moving average; first sample is taken as is
+  const float sample = float(busyNs.load())/float(workSize);
+  site.nsPerItem.store(ns>0 ? ns+(sample-ns)*0.125f : sample, std::memory_order_relaxed);
   }
@@ -3,32 +3,60 @@
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
 #include <functional>
 #include <atomic>
 #include <algorithm>
 #include <condition_variable>
+#include <initializer_list>
+#include <source_location>
+#include <string_view>
 #include <new>
 
 class Workers final {
+  private:
+    struct Job;
+
   public:
     Workers();
     ~Workers();
 
+    class Task final {
+      public:
+        Task() = default;
+        bool isDone() const;
+
+      private:
+        explicit Task(std::shared_ptr<Job> j):job(std::move(j)){}
+        std::shared_ptr<Job> job;
+
+      friend class Workers;
+      };
+
     static void setThreadName(const char* threadName);
+    // must be called before first parallel job; threads==0 - autodetect
+    static void setup(uint32_t threads, bool pinThreads);
+
+    // schedule independent job; starts once all of deps are done
+    static Task spawn(std::function<void()> fn, std::initializer_list<Task> deps = {});
+    // helps to execute pending jobs, while waiting
+    static void wait(const Task& t);
 
     template<class T,class F>
-    static void parallelFor(T* b, T* e, const F& func) {
-      inst().runParallelFor(b,std::distance(b,e),func);
+    static void parallelFor(T* b, T* e, const F& func, const std::source_location& loc = std::source_location::current()) {
+      inst().runParallelFor(b,size_t(std::distance(b,e)),func,loc);
       }
 
     template<class T,class F>
-    static void parallelFor(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),func);
+    static void parallelFor(std::vector<T>& data, const F& func, const std::source_location& loc = std::source_location::current()) {
+      inst().runParallelFor(data.data(),data.size(),func,loc);
       }
 
     template<class T,class F>
-    static void parallelTasks(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),func);
+    static void parallelTasks(std::vector<T>& data, const F& func, const std::source_location& loc = std::source_location::current()) {
+      inst().runParallelFor(data.data(),data.size(),func,loc);
       }
 
     template<class F>
@@ -36,65 +64,120 @@ class Workers final {
       inst().runParallelTasks<F>(taskCount,func);
       }
 
-    static uint8_t maxThreads();
+    static uint32_t maxThreads();
 
-  private:
-    enum { MAX_THREADS=16 };
+    struct CallSiteStat {
+      std::string_view file;
+      uint32_t         line      = 0;
+      uint64_t         calls     = 0;
+      float            nsPerItem = 0;
+      uint32_t         step      = 0;
+      uint32_t         threads   = 0;
+      };
+    static std::vector<CallSiteStat> callSiteStats();
 
-    void            threadFunc(size_t id);
-    void            execWork(uint32_t& minWorkSize);
-    uint32_t        taskLoop();
+  private:
+    struct Job {
+      std::function<void()>             func;
+      std::atomic_int                   pending{1};
+      std::atomic_bool                  done{false};
+      std::mutex                        sync;
+      std::vector<std::shared_ptr<Job>> next;
+      };
+
+    struct alignas(64) Queue {
+      std::mutex                        sync;
+      std::deque<std::shared_ptr<Job>>  jobs;
+      };
+
+    // per parallelFor call site: smoothed cost of one item, to pick batch size and thread count
+    struct CallSite {
+      explicit CallSite(const std::source_location& loc);
+      const char*                       file = nullptr;
+      uint32_t                          line = 0;
+      std::atomic<uint64_t>             calls{0};
+      std::atomic<float>                nsPerItem{0};
+      std::atomic<uint32_t>             step{0};
+      std::atomic<uint32_t>             threads{0};
+      };
+
+    using RangeFn = void(*)(const void* ctx, size_t b, size_t e);
+
+    void            threadFunc(size_t id, int32_t cpu);
+    void            push(std::shared_ptr<Job> job);
+    auto            pop() -> std::shared_ptr<Job>;
+    void            exec(std::shared_ptr<Job> job);
+    void            execWork(size_t workSize, CallSite& site, const void* ctx, RangeFn fn);
     static Workers& inst();
 
-    template<class T,class F>
-    static uint32_t&  minWorkSize() {
-      static uint32_t data = 0;
-      return data;
-      }
+    struct CallSiteKey {
+      std::string_view file;
+      uint32_t         line = 0;
+      bool operator == (const CallSiteKey& other) const { return line==other.line && file==other.file; }
+      };
 
+    struct CallSiteHash {
+      size_t operator()(const CallSiteKey& k) const { return std::hash<std::string_view>()(k.file) ^ (size_t(k.line)*0x9E3779B9u); }
+      };
+
+    using CallSiteMap = std::unordered_map<CallSiteKey,std::unique_ptr<CallSite>,CallSiteHash>;
+
+    // lock-free lookup table: file_name pointer and line, resolved to site once
+    struct CallSiteRef {
+      const char*                       file = nullptr;
+      uint32_t                          line = 0;
+      CallSite*                         site = nullptr;
+      };
+    static constexpr size_t           CallSiteSlots = 256;
+
+    static CallSite&  callSite(const std::source_location& loc);
+    static CallSite&  implRegisterCallSite(const std::source_location& loc, size_t hash);
 
     template<class T,class F>
-    void runParallelFor(T* data, size_t sz, const F& func) {
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      workSize    = sz;
-      workEltSize = sizeof(T);
-
-      workFunc = [&func](void* data, size_t sz) {
-        T* tdata = reinterpret_cast<T*>(data);
-        for(size_t i=0;i<sz;++i)
-          func(tdata[i]);
+    void runParallelFor(T* data, size_t sz, const F& func, const std::source_location& loc) {
+      struct Ctx {
+        T*       data;
+        const F* func;
         };
-
-      execWork(minWorkSize<T,F>());
+      Ctx ctx = {data, &func};
+      execWork(sz, callSite(loc), &ctx, [](const void* c, size_t b, size_t e) {
+        auto& ctx = *reinterpret_cast<const Ctx*>(c);
+        for(size_t i=b; i<e; ++i)
+          (*ctx.func)(ctx.data[i]);
+        });
       }
 
     template<class F>
     void runParallelTasks(size_t taskCount, const F& func) {
-      workSet     = nullptr;
-      workSize    = taskCount;
-      workEltSize = 1;
-
-      workFunc = [&func](void* data, size_t sz) {
-        func(reinterpret_cast<uintptr_t>(data));
-        };
-      execWork(minWorkSize<void,F>());
+      if(taskCount==0)
+        return;
+      std::vector<Task> tasks(taskCount-1);
+      for(size_t i=1; i<taskCount; ++i)
+        tasks[i-1] = spawn([&func,i](){ func(i); });
+      func(size_t(0));
+      for(auto& t:tasks)
+        wait(t);
       }
 
-    static const size_t               taskPerThread;
-    static const size_t               taskPerStep;
-    bool                              running=true;
-
-    std::thread                       th[MAX_THREADS];
+    static const uint64_t             minTaskNs;
+    static const uint64_t             stepNs;
+    static const uint32_t             spinCount;
+    static std::mutex                 callSiteSync;
+    static std::vector<CallSite*>     callSiteList;
+    static CallSiteMap                callSiteMap;
+    static std::vector<std::unique_ptr<CallSiteRef>> callSiteRefList;
+    static std::atomic<const CallSiteRef*>           callSiteRef[CallSiteSlots];
+    std::atomic_bool                  running{true};
+
+    std::vector<std::thread>          th;
+    // one queue per worker, last one is shared by non-worker threads
+    std::unique_ptr<Queue[]>          queue;
+    size_t                            queueCount = 0;
 
     std::mutex                        sync;
     std::condition_variable           workWait;
-    int32_t                           workTbd = 0;
-
-    uint8_t*                          workSet=nullptr;
-    size_t                            workSize=0, workEltSize=0;
-    std::function<void(void*,size_t)> workFunc;
-
-    std::atomic_int                   progressIt{0};
-    uint32_t                          taskCount = 0;
-    std::atomic_int                   taskDone{0};
+    std::condition_variable           doneWait;
+    std::atomic_int                   queued{0};
+    std::atomic_int                   parked{0};
+    std::atomic_int                   waiters{0};
   };
@@ -0,0 +1,80 @@
+#include "aabbgrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void AabbGrid::clear() {
+  points.clear();
+  large.clear();
+  }
+
+void AabbGrid::insert(uint32_t id, const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  const int32_t  x0 = cellCoord(min.x), x1 = cellCoord(max.x);
+  const int32_t  y0 = cellCoord(min.y), y1 = cellCoord(max.y);
+  const int32_t  z0 = cellCoord(min.z), z1 = cellCoord(max.z);
+  const uint64_t range = uint64_t(x1-x0+1)*uint64_t(y1-y0+1)*uint64_t(z1-z0+1);
+
+  if(x1<x0 || y1<y0 || z1<z0 || range>MaxCells) {
+    large.push_back(id);
+    return;
+    }
+
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t y=y0; y<=y1; ++y)
+      for(int32_t z=z0; z<=z1; ++z) {
+        Point pt;
+        pt.key = cellKey(x,y,z);
+        pt.id  = id;
+        points.push_back(pt);
+        }
+  }
+
+void AabbGrid::finalize() {
+  std::sort(points.begin(), points.end());
+  }
+
+void AabbGrid::find(const Tempest::Vec3& min, const Tempest::Vec3& max, std::vector<uint32_t>& out) const {
+  out.clear();
+  out.insert(out.end(), large.begin(), large.end());
+
+  const int32_t  x0 = cellCoord(min.x), x1 = cellCoord(max.x);
+  const int32_t  y0 = cellCoord(min.y), y1 = cellCoord(max.y);
+  const int32_t  z0 = cellCoord(min.z), z1 = cellCoord(max.z);
+  const uint64_t range = uint64_t(x1-x0+1)*uint64_t(y1-y0+1)*uint64_t(z1-z0+1);
+
+  if(range>=points.size()) {
+    for(auto& i:points)
+      out.push_back(i.id);
+    }
+  else {
+    for(int32_t x=x0; x<=x1; ++x)
+      for(int32_t y=y0; y<=y1; ++y)
+        for(int32_t z=z0; z<=z1; ++z) {
+          Point pt;
+          pt.key = cellKey(x,y,z);
+          auto it = std::lower_bound(points.begin(), points.end(), pt);
+          for(; it!=points.end() && it->key==pt.key; ++it)
+            out.push_back(it->id);
+          }
+    }
+
+  // box may span several cells
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  }
+
+int32_t AabbGrid::cellCoord(float v) {
+  // 21 bit per axis
+  const float lim = float(1<<20) - 1.f;
+  const float c   = std::floor(v/CellSize);
+  if(!(c>-lim))
+    return -int32_t(lim);
+  if(!(c<lim))
+    return int32_t(lim);
+  return int32_t(c);
+  }
+
+uint64_t AabbGrid::cellKey(int32_t x, int32_t y, int32_t z) {
+  const uint64_t mask = (1u<<21)-1u;
+  return (uint64_t(x+(1<<20)) & mask) | ((uint64_t(y+(1<<20)) & mask)<<21) | ((uint64_t(z+(1<<20)) & mask)<<42);
+  }
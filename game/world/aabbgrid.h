@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <Tempest/Point>
+
+// Axis-aligned boxes, bucketed into uniform grid. Rebuilt on demand, queries return ids in ascending order.
+class AabbGrid final {
+  public:
+    AabbGrid() = default;
+
+    void   clear();
+    void   insert(uint32_t id, const Tempest::Vec3& min, const Tempest::Vec3& max);
+    void   finalize();
+
+    // candidates, that may overlap with box [min,max]
+    void   find(const Tempest::Vec3& min, const Tempest::Vec3& max, std::vector<uint32_t>& out) const;
+
+    static constexpr float    CellSize = 1000.f;
+    static constexpr uint64_t MaxCells = 512;  // bigger boxes are always reported as candidates
+
+  private:
+    struct Point {
+      uint64_t key = 0;
+      uint32_t id  = 0;
+      bool operator < (const Point& other) const {
+        return key<other.key || (key==other.key && id<other.id);
+        }
+      };
+
+    static int32_t  cellCoord(float v);
+    static uint64_t cellKey(int32_t x, int32_t y, int32_t z);
+
+    std::vector<Point>    points;
+    std::vector<uint32_t> large;
+  };
@@ -2,6 +2,9 @@
 
 #include <Tempest/Log>
 
+#include <algorithm>
+#include <cmath>
+
 #include "world/objects/npc.h"
 #include "worldobjects.h"
 #include "world.h"
@@ -94,6 +97,29 @@ void CollisionZone::load(Serialize& fin) {
       }
   }
 
+void CollisionZone::bounds(Tempest::Vec3& min, Tempest::Vec3& max) const {
+  auto sz = Tempest::Vec3(std::fabs(size.x), std::fabs(size.y), std::fabs(size.z));
+  if(type==T_Capsule)
+    sz.z = sz.x;
+  min = pos - sz;
+  max = pos + sz;
+  }
+
+void CollisionZone::bounds(const Npc& npc, Tempest::Vec3& min, Tempest::Vec3& max) {
+  auto bbox = npc.bBox();
+  auto pos  = npc.centerPosition();
+  auto sz   = Tempest::Vec3(0);
+  if(bbox!=nullptr) {
+    sz  = (bbox[1] - bbox[0])*0.5f;
+    pos = pos + (bbox[1] + bbox[0])*0.5f;
+    }
+  // capsule test uses x-extent for both horizontal axes
+  const float xz = std::max(std::fabs(sz.x), std::fabs(sz.z));
+  sz  = Tempest::Vec3(xz, std::fabs(sz.y), xz);
+  min = pos - sz;
+  max = pos + sz;
+  }
+
 bool CollisionZone::checkPos(const Npc& npc) const {
   //NOTE: according to test-case in Karibik bbox seem to be visual one, not the collision box
   // auto bbox = npc.bBoxCol();
@@ -32,6 +32,10 @@ class CollisionZone final {
 
     const std::vector<Npc*>& intersections() const { return intersect; }
 
+    // conservative bounds for broadphase; checkPos can be true only if boxes overlap
+    void          bounds(Tempest::Vec3& min, Tempest::Vec3& max) const;
+    static void   bounds(const Npc& npc, Tempest::Vec3& min, Tempest::Vec3& max);
+
     bool          checkPos(const Npc& npc) const;
     void          onIntersect(Npc& npc);
     void          tick(uint64_t dt);
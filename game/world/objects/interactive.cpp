@@ -249,6 +249,18 @@ void Interactive::updateAnimation(uint64_t dt) {
     animChanged = true;
   }
 
+void Interactive::setAnimLod(uint64_t interval, bool skipMinor) {
+  visual.setAnimLod(interval,skipMinor);
+  }
+
+bool Interactive::needsBones() const {
+  // npc's, that use this mobsi, are placed by its nodes
+  for(auto& i:attPos)
+    if(i.user!=nullptr)
+      return true;
+  return false;
+  }
+
 void Interactive::tick(uint64_t dt) {
   visual.processLayers(world);
 
@@ -36,6 +36,8 @@ class Interactive : public Vob {
 
     void                resetPositionToTA(int32_t state);
     void                updateAnimation(uint64_t dt);
+    void                setAnimLod(uint64_t interval, bool skipMinor);
+    bool                needsBones() const;
     void                tick(uint64_t dt);
     void                onKeyInput(KeyCodec::Action act);
 
@@ -400,6 +400,7 @@ bool Npc::setPosition(float ix, float iy, float iz) {
   z = iz;
   durtyTranform |= TR_Pos;
   physic.setPosition(Vec3{x,y,z});
+  implCheckGridMove();
   return true;
   }
 
@@ -412,6 +413,13 @@ void Npc::setViewPosition(const Tempest::Vec3& pos) {
   y = pos.y;
   z = pos.z;
   durtyTranform |= TR_Pos;
+  implCheckGridMove();
+  }
+
+void Npc::implCheckGridMove() {
+  // teleport or big move: grid snapshot won't report this npc anymore, rebuild on next query
+  if((Vec3(x,y,z)-gridPos).quadLength()>PointGrid::Slack*PointGrid::Slack)
+    owner.invalidateNpcGrid();
   }
 
 int Npc::aiOutputOrderId() const {
@@ -1363,8 +1371,9 @@ bool Npc::implLookAtWp(uint64_t dt) {
 bool Npc::implLookAtNpc(uint64_t dt) {
   if(currentLookAtNpc==nullptr)
     return false;
-  auto selfHead  = visual.mapHeadBone();
-  auto otherHead = currentLookAtNpc->visual.mapHeadBone();
+  // heads as of frame start: result doesn't depend on whether target was ticked before this npc
+  auto selfHead  = headSnapshot();
+  auto otherHead = currentLookAtNpc->headSnapshot();
   auto dvec = otherHead - selfHead;
   return implLookAt(dvec.x,dvec.y,dvec.z,dt);
   }
@@ -2165,7 +2174,7 @@ Npc *Npc::updateNearestEnemy() {
   Npc*  ret  = nullptr;
   float dist = std::numeric_limits<float>::max();
   if(nearestEnemy!=nullptr &&
-     (!nearestEnemy->isDown() && canSenseNpc(*nearestEnemy,true)!=SensesBit::SENSE_NONE)) {
+     (!nearestEnemy->isDown() && canSenseNpcCached(*nearestEnemy,true)!=SensesBit::SENSE_NONE)) {
     ret  = nearestEnemy;
     dist = qDistTo(*ret);
     }
@@ -2175,7 +2184,7 @@ Npc *Npc::updateNearestEnemy() {
       return;
 
     float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
+    if(d<dist && canSenseNpcCached(n,true)!=SensesBit::SENSE_NONE) {
       ret  = &n;
       dist = d;
       }
@@ -2196,7 +2205,7 @@ Npc* Npc::updateNearestBody() {
       return;
 
     float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
+    if(d<dist && canSenseNpcCached(n,true)!=SensesBit::SENSE_NONE) {
       ret  = &n;
       dist = d;
       }
@@ -2295,17 +2304,20 @@ void Npc::tickTimedEvt(Animation::EvCount& ev) {
     }
   }
 
-void Npc::tickRegen(int32_t& v, const int32_t max, const int32_t chg, const uint64_t dt) {
+int32_t Npc::regenDelta(const int32_t chg, const uint64_t dt) const {
   uint64_t tick = owner.tickCount();
   if(tick<dt || chg==0)
-    return;
+    return 0;
   int32_t time0 = int32_t(tick%1000);
   int32_t time1 = time0+int32_t(dt);
 
   int32_t val0 = (time0*chg)/1000;
   int32_t val1 = (time1*chg)/1000;
+  return val1-val0;
+  }
 
-  int32_t nextV = std::max(0,std::min(v+val1-val0,max));
+void Npc::tickRegen(int32_t& v, const int32_t max, const int32_t chg) {
+  int32_t nextV = std::max(0,std::min(v+chg,max));
   if(v!=nextV) {
     v = nextV;
     // check health, in case of negative chg
@@ -2331,6 +2343,46 @@ void Npc::tickAnimationTags() {
   tickTimedEvt(ev);
   }
 
+void Npc::tickCompute(uint64_t dt, int32_t diveTick) {
+  implTickCompute(tickCmp,dt,diveTick);
+  mvAlgo.prefetch(tickCmp.move,dt);
+  }
+
+bool Npc::tickComputeCheck(uint64_t dt, int32_t diveTick) const {
+  TickCompute tc;
+  implTickCompute(tc,dt,diveTick);
+  mvAlgo.prefetch(tc.move,dt);
+  return tc==tickCmp;
+  }
+
+void Npc::implTickCompute(TickCompute& out, uint64_t dt, int32_t diveTick) const {
+  // reads own state and static world only: safe on workers, no npc moves until commit
+  out       = TickCompute();
+  out.time  = owner.tickCount();
+  out.dt    = dt;
+  out.valid = true;
+  out.head  = visual.mapHeadBone();
+
+  if(isDive()) {
+    int32_t v = owner.script().guildVal().dive_time[guild()]*1000;
+    int32_t t = diveTime();
+    if(v>=0 && t>v+int(dt) && diveTick>0) {
+      t-=v;
+      out.diveDmg = t/diveTick - (t-int(dt))/diveTick;
+      }
+    }
+
+  out.regenHp   = regenDelta(hnpc->attribute[ATR_REGENERATEHP],  dt);
+  out.regenMana = regenDelta(hnpc->attribute[ATR_REGENERATEMANA],dt);
+  }
+
+Tempest::Vec3 Npc::headSnapshot() const {
+  if(tickCmp.time==owner.tickCount())
+    return tickCmp.head;
+  // not ticked yet in this frame, so not moved either
+  return visual.mapHeadBone();
+  }
+
 void Npc::tick(uint64_t dt) {
   static bool dbg = false;
   static int  kId = 432;
@@ -2339,26 +2391,28 @@ void Npc::tick(uint64_t dt) {
 
   assert(go2.flag!=GoToHint::GT_Enemy && go2.flag!=GoToHint::GT_EnemyG);
 
+  if(!tickCmp.valid || tickCmp.time!=owner.tickCount() || tickCmp.dt!=dt) {
+    // not in parallel phase: player with free camera, far npc's, catch-up slices of long tick
+    // ground probes are left to MoveAlgo here, prediction only pays off on workers
+    const bool sameFrame = (tickCmp.time==owner.tickCount());
+    const auto head      = tickCmp.head;
+    implTickCompute(tickCmp,dt,isDive() ? world().script().npcDamDiveTime() : 0);
+    if(sameFrame)
+      tickCmp.head = head; // other npc's might have looked at it already
+    }
+  tickCmp.valid = false;
+  const TickCompute& tc = tickCmp;
+
+  mvAlgo.setPrefetch(tc.move);
   tickAnimationTags();
 
   if(!visual.pose().hasAnim())
     setAnim(AnimationSolver::Idle);
 
-  if(isDive()) {
-    uint32_t gl = guild();
-    int32_t  v  = world().script().guildVal().dive_time[gl]*1000;
-    int32_t  t  = diveTime();
-    if(v>=0 && t>v+int(dt)) {
-      int tickSz = world().script().npcDamDiveTime();
-      if(tickSz>0) {
-        t-=v;
-        int dmg = t/tickSz - (t-int(dt))/tickSz;
-        if(dmg>0) {
-          lastHit = nullptr;
-          changeAttribute(ATR_HITPOINTS,-dmg,false);
-          }
-        }
-      }
+  // script-visible effects of compute phase: applied here, in npc-id order
+  if(tc.diveDmg>0) {
+    lastHit = nullptr;
+    changeAttribute(ATR_HITPOINTS,-tc.diveDmg,false);
     }
 
   nextAiAction(aiQueueOverlay,dt);
@@ -2367,10 +2421,8 @@ void Npc::tick(uint64_t dt) {
     return;
 
   if(!isDead()) {
-    tickRegen(hnpc->attribute[ATR_HITPOINTS],hnpc->attribute[ATR_HITPOINTSMAX],
-              hnpc->attribute[ATR_REGENERATEHP],dt);
-    tickRegen(hnpc->attribute[ATR_MANA],hnpc->attribute[ATR_MANAMAX],
-              hnpc->attribute[ATR_REGENERATEMANA],dt);
+    tickRegen(hnpc->attribute[ATR_HITPOINTS],hnpc->attribute[ATR_HITPOINTSMAX],tc.regenHp);
+    tickRegen(hnpc->attribute[ATR_MANA],     hnpc->attribute[ATR_MANAMAX],     tc.regenMana);
     }
 
   if(waitTime>=owner.tickCount() || aniWaitTime>=owner.tickCount() || outWaitTime>owner.tickCount()) {
@@ -4197,12 +4249,13 @@ bool Npc::perceptionProcess(Npc &pl) {
 
   bool ret=false;
   if(processPolicy()!=NpcProcessPolicy::AiNormal) {
+    perceptionSense.clear();
     perceptionNextTime = owner.tickCount()+perceptionTimeClampt();
     return ret;
     }
 
   const float quadDist = pl.qDistTo(*this);
-  if(hasPerc(PERC_ASSESSPLAYER) && canSenseNpc(pl,false)!=SensesBit::SENSE_NONE) {
+  if(hasPerc(PERC_ASSESSPLAYER) && canSenseNpcCached(pl,false)!=SensesBit::SENSE_NONE) {
     if(perceptionProcess(pl,nullptr,quadDist,PERC_ASSESSPLAYER)) {
       ret = true;
       }
@@ -4227,10 +4280,82 @@ bool Npc::perceptionProcess(Npc &pl) {
     }
 
   // if(aiQueue.size()==0) // NOTE: Gothic1 fights
+  perceptionSense.clear();
   perceptionNextTime = owner.tickCount()+perceptionTimeClampt();
   return ret;
   }
 
+template<class F>
+void Npc::prefetchNearest(const F& pred) {
+  // updateNearestEnemy/updateNearestBody pick closest sensed npc: test candidates from near to far, until first hit
+  std::vector<std::pair<float,const Npc*>> cand;
+  owner.detectNpcNear([this,&pred,&cand](Npc& n){
+    if(pred(n))
+      cand.emplace_back(qDistTo(n),&n);
+    });
+  std::stable_sort(cand.begin(),cand.end(),[](const std::pair<float,const Npc*>& l, const std::pair<float,const Npc*>& r){
+    return l.first<r.first;
+    });
+  for(auto& [d,n]:cand) {
+    if(prefetchSense(*n,true)!=SensesBit::SENSE_NONE)
+      break;
+    }
+  }
+
+SensesBit Npc::prefetchSense(const Npc& oth, bool freeLos) {
+  for(auto& i:perceptionSense)
+    if(i.npc==&oth && i.freeLos==freeLos)
+      return i.sense;
+  PercSense s;
+  s.npc     = &oth;
+  s.freeLos = freeLos;
+  s.sense   = canSenseNpc(oth,freeLos);
+  s.from    = position();
+  s.to      = oth.centerPosition();
+  s.angle   = angle;
+  perceptionSense.push_back(s);
+  return s.sense;
+  }
+
+SensesBit Npc::canSenseNpcCached(const Npc& oth, bool freeLos) const {
+  if(perceptionSenseTime!=owner.tickCount())
+    return canSenseNpc(oth,freeLos);
+  for(auto& i:perceptionSense) {
+    if(i.npc!=&oth || i.freeLos!=freeLos)
+      continue;
+    // anyone moved or turned since gather (i.e. by script of previous npc) - snapshot is stale
+    if(i.from!=position() || i.to!=oth.centerPosition() || i.angle!=angle)
+      break;
+    return i.sense;
+    }
+  return canSenseNpc(oth,freeLos);
+  }
+
+void Npc::perceptionPrefetch(const Npc& pl) {
+  // read-only part of perceptionProcess: precompute line-of-sight tests, that later are consumed in same order
+  perceptionSense.clear();
+  perceptionSenseTime = owner.tickCount();
+  if(isPlayer() || processPolicy()!=NpcProcessPolicy::AiNormal)
+    return;
+
+  if(hasPerc(PERC_ASSESSPLAYER))
+    prefetchSense(pl,false);
+
+  if(hasPerc(PERC_ASSESSENEMY)) {
+    if(nearestEnemy!=nullptr && !nearestEnemy->isDown())
+      prefetchSense(*nearestEnemy,true);
+    prefetchNearest([this](const Npc& n){
+      return &n!=this && !n.isDown() && isEnemy(n);
+      });
+    }
+
+  if(hasPerc(PERC_ASSESSBODY)) {
+    prefetchNearest([](const Npc& n){
+      return n.isDead();
+      });
+    }
+  }
+
 bool Npc::perceptionProcess(Npc &pl, Npc* victim, float quadDist, PercType perc) {
   if(!aiState.started && aiState.funcIni.isValid()) {
     // avoid ugly soft-lock (ZS_MM_Attack <-> B_MM_AssessWarn) for the orks near ramp
@@ -4666,7 +4791,7 @@ bool Npc::canRayHitPoint(const Tempest::Vec3 self, const Tempest::Vec3 pos, floa
   const DynamicWorld* w   = owner.physic();
   bool freeLos = angOverride>=180.f;
   if(freeLos) {
-    return !w->ray(self, pos).hasCol;
+    return w->rayLos(losObserver, self, pos);
     }
 
   float dx  = self.x-pos.x, dz=self.z-pos.z;
@@ -4674,7 +4799,7 @@ bool Npc::canRayHitPoint(const Tempest::Vec3 self, const Tempest::Vec3 pos, floa
   float da  = float(M_PI)*(visual.viewDirection()-dir)/180.f;
   auto  ca  = angOverride > 0 ? std::cos(angOverride*M_PI/180.0) : ref;
   if(double(std::cos(da))<=ca) {
-    if(!w->ray(self, pos).hasCol)
+    if(w->rayLos(losObserver, self, pos))
       return true;
     }
   return false;
@@ -4794,6 +4919,16 @@ void Npc::updateTransform() {
   updateAnimation(0, true);
   }
 
+void Npc::setAnimLod(uint64_t interval, bool skipMinor) {
+  visual.setAnimLod(interval,skipMinor);
+  }
+
+bool Npc::needsBones() const {
+  // head bone: line of sight in perception; hands and weapon: fight, spells; mobsi: attach points
+  return aiPolicy<=NpcProcessPolicy::AiNormal || currentTarget!=nullptr || currentInteract!=nullptr ||
+         weaponState()!=WeaponState::NoWeapon || isCasting();
+  }
+
 void Npc::updateAnimation(uint64_t dt, bool force) {
   const auto camera = Gothic::inst().camera();
   if(isPlayer() && camera!=nullptr && camera->isFree())
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include <zenkit/addon/daedalus.hh>
 
@@ -87,6 +88,7 @@ class Npc final {
 
     bool       setPosition (float x,float y,float z);
     bool       setPosition (const Tempest::Vec3& pos);
+    void       syncGridPosition() { gridPos = Tempest::Vec3(x,y,z); }
     void       setDirection(const Tempest::Vec3& pos);
     void       setDirection(float rotation);
     void       setDirectionY(float rotation);
@@ -112,11 +114,16 @@ class Npc final {
 
     void       setProcessPolicy(NpcProcessPolicy t);
     auto       processPolicy() const -> NpcProcessPolicy { return aiPolicy; }
+    void       deferTick(uint64_t dt) { tickDeferred += dt; }
+    uint64_t   deferredTime() const   { return tickDeferred; }
+    uint64_t   takeDeferredTime()     { return std::exchange(tickDeferred,uint64_t(0)); }
 
     bool       isPlayer() const;
     void       setWalkMode(WalkBit m);
     auto       walkMode() const { return wlkMode; }
     void       tick(uint64_t dt);
+    void       tickCompute(uint64_t dt, int32_t diveTick);
+    bool       tickComputeCheck(uint64_t dt, int32_t diveTick) const;
     void       tickAnimationTags();
     bool       startClimb(JumpStatus jump);
 
@@ -136,6 +143,8 @@ class Npc final {
     auto       fightDistanceTo(const Npc& npc) const -> Tempest::Vec3;
 
     void       updateAnimation(uint64_t dt, bool force = false);
+    void       setAnimLod(uint64_t interval, bool skipMinor);
+    bool       needsBones() const;
     void       updateTransform();
 
     std::string_view displayName() const;
@@ -295,6 +304,7 @@ class Npc final {
     void      setPerceptionEnable (PercType t, size_t fn);
     void      setPerceptionDisable(PercType t);
 
+    void      perceptionPrefetch(const Npc& pl);
     bool      perceptionProcess(Npc& pl);
     bool      perceptionProcess(Npc& pl, Npc *victim, float quadDist, PercType perc);
     bool      hasPerc(PercType perc) const;
@@ -451,6 +461,29 @@ class Npc final {
       ScriptFn func;
       };
 
+    struct PercSense final {
+      const Npc*    npc     = nullptr;
+      bool          freeLos = false;
+      SensesBit     sense   = SensesBit::SENSE_NONE;
+      // state at gather time; script callbacks of other npc's may move/turn either side
+      Tempest::Vec3 from;
+      Tempest::Vec3 to;
+      float         angle   = 0;
+      };
+
+    // parallel part of tick: computed against state of frame start, applied by tick in npc-id order
+    struct TickCompute final {
+      uint64_t           time      = uint64_t(-1);
+      uint64_t           dt        = 0;
+      bool               valid     = false;
+      int32_t            diveDmg   = 0;
+      int32_t            regenHp   = 0;
+      int32_t            regenMana = 0;
+      Tempest::Vec3      head;
+      MoveAlgo::Prefetch move;
+      bool operator == (const TickCompute& other) const = default;
+      };
+
     struct GoTo final {
       GoToHint         flag = GoToHint::GT_No;
       Npc*             npc  = nullptr;
@@ -472,8 +505,16 @@ class Npc final {
       };
 
     void      updateWeaponSkeleton();
+    template<class F>
+    void      prefetchNearest(const F& pred);
+    auto      prefetchSense(const Npc& oth, bool freeLos) -> SensesBit;
+    auto      canSenseNpcCached(const Npc& oth, bool freeLos) const -> SensesBit;
+
+    void      implTickCompute(TickCompute& out, uint64_t dt, int32_t diveTick) const;
+    auto      headSnapshot() const -> Tempest::Vec3;
     void      tickTimedEvt(Animation::EvCount &ev);
-    void      tickRegen(int32_t& v,const int32_t max,const int32_t chg, const uint64_t dt);
+    int32_t   regenDelta(const int32_t chg, const uint64_t dt) const;
+    void      tickRegen(int32_t& v,const int32_t max,const int32_t chg);
     void      setViewPosition(const Tempest::Vec3& pos);
     bool      tickCast(uint64_t dt);
 
@@ -483,6 +524,7 @@ class Npc final {
     auto      currentRoutine(bool assertWp = false) const -> const Routine&;
     gtime     endTime(const Routine& r) const;
 
+    void      implCheckGridMove();
     bool      implPointAt(const Tempest::Vec3& to);
     bool      implLookAtWp(uint64_t dt);
     bool      implLookAtNpc(uint64_t dt);
@@ -543,6 +585,7 @@ class Npc final {
     float                          x=0.f;
     float                          y=0.f;
     float                          z=0.f;
+    Tempest::Vec3                  gridPos; // position in WorldObjects::npcGrid snapshot
     float                          angle    = 0.f;
     float                          sz[3]={1.f,1.f,1.f};
 
@@ -573,6 +616,8 @@ class Npc final {
     uint64_t                       perceptionTime    =0;
     uint64_t                       perceptionNextTime=0;
     Perc                           perception[PERC_Count];
+    std::vector<PercSense>         perceptionSense;
+    uint64_t                       perceptionSenseTime=0;
 
     // inventory
     Inventory                      invent;
@@ -603,6 +648,7 @@ class Npc final {
 
     uint64_t                       aiOutputBarrier=0;
     NpcProcessPolicy               aiPolicy=NpcProcessPolicy::AiNormal;
+    uint64_t                       tickDeferred=0;
     AiState                        aiState;
     ScriptFn                       aiPrevState;
     AiQueue                        aiQueue;
@@ -630,6 +676,8 @@ class Npc final {
     MoveAlgo                       mvAlgo;
     FightAlgo                      fghAlgo;
     uint64_t                       lastEventTime=0;
+    TickCompute                    tickCmp;
+    uint64_t                       losObserver=LosCache::mkObserverId();
 
     float                          angleY   = 0.f;
     float                          runAng   = 0.f;
@@ -0,0 +1,82 @@
+#include "pathcache.h"
+
+#include <algorithm>
+#include <iterator>
+
+auto PathCache::find(uint32_t dest, bool& build) -> std::shared_ptr<const Field> {
+  std::lock_guard<std::mutex> guard(sync);
+  build = false;
+
+  auto it = index.find(dest);
+  if(it==index.end()) {
+    ++miss;
+    // first request: only remember destination, one-off requests can't push built fields out of lru
+    auto& s = seen[seenSlot(dest)];
+    if(s==dest+1) {
+      s     = 0;
+      build = true;
+      } else {
+      s     = dest+1;
+      }
+    return nullptr;
+    }
+
+  lru.splice(lru.begin(), lru, it->second);
+  ++hit;
+  return it->second->field;
+  }
+
+void PathCache::push(uint32_t dest, std::shared_ptr<const Field> f) {
+  if(f==nullptr)
+    return;
+  std::lock_guard<std::mutex> guard(sync);
+  auto it = index.find(dest);
+  if(it==index.end()) {
+    Entry e;
+    e.dest = dest;
+    lru.push_front(e);
+    it = index.emplace(dest,lru.begin()).first;
+    } else {
+    lru.splice(lru.begin(), lru, it->second);
+    }
+
+  auto& e = *it->second;
+  if(e.field!=nullptr)
+    bytes -= e.field->byteSize();
+  e.field = std::move(f);
+  bytes  += e.field->byteSize();
+  evict();
+  }
+
+void PathCache::invalidate() {
+  std::lock_guard<std::mutex> guard(sync);
+  lru.clear();
+  index.clear();
+  std::fill(std::begin(seen), std::end(seen), 0);
+  bytes = 0;
+  }
+
+PathCache::Stat PathCache::stat() const {
+  std::lock_guard<std::mutex> guard(sync);
+  Stat s;
+  s.hit   = hit;
+  s.miss  = miss;
+  s.size  = index.size();
+  s.bytes = bytes;
+  return s;
+  }
+
+size_t PathCache::seenSlot(uint32_t dest) {
+  return size_t((dest*2654435761u) >> 22) % SeenSlots;
+  }
+
+void PathCache::evict() {
+  // most recent entry always survives
+  while(lru.size()>1 && (bytes>MaxBytes || lru.size()>MaxEntries)) {
+    auto& e = lru.back();
+    if(e.field!=nullptr)
+      bytes -= e.field->byteSize();
+    index.erase(e.dest);
+    lru.pop_back();
+    }
+  }
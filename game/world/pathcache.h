@@ -0,0 +1,58 @@
+#pragma once
+
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Distance fields of waynet, one per destination, with LRU eviction.
+// Field is built only for destinations, that were requested more than once;
+// first requests are tracked in a separate small table and don't take LRU slots
+class PathCache final {
+  public:
+    PathCache() = default;
+
+    struct Field {
+      std::vector<int32_t>  cost;   // path length to destination
+      std::vector<uint32_t> parent; // next point towards destination
+      size_t byteSize() const { return cost.size()*sizeof(int32_t) + parent.size()*sizeof(uint32_t); }
+      };
+
+    struct Stat {
+      uint64_t hit     = 0;
+      uint64_t miss    = 0;
+      size_t   size    = 0;
+      size_t   bytes   = 0;
+      };
+
+    static constexpr size_t MaxBytes   = 8*1024*1024;
+    static constexpr size_t MaxEntries = 256;
+    static constexpr size_t SeenSlots  = 1024;
+
+    // nullptr on miss; 'build' is set, if caller should compute field and push it
+    auto find(uint32_t dest, bool& build) -> std::shared_ptr<const Field>;
+    void push(uint32_t dest, std::shared_ptr<const Field> f);
+
+    void invalidate();
+    Stat stat() const;
+
+  private:
+    struct Entry {
+      uint32_t                     dest = 0;
+      std::shared_ptr<const Field> field;
+      };
+
+    void evict();
+    static size_t seenSlot(uint32_t dest);
+
+    mutable std::mutex                                         sync;
+    std::list<Entry>                                           lru;
+    std::unordered_map<uint32_t,std::list<Entry>::iterator>    index;
+    uint32_t                                                   seen[SeenSlots] = {}; // dest+1, direct-mapped
+    size_t                                                     bytes = 0;
+    uint64_t                                                   hit   = 0;
+    uint64_t                                                   miss  = 0;
+  };
@@ -0,0 +1,54 @@
+#include "pointgrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+int32_t PointGrid::cellCoord(float v) {
+  // 21 bit per axis
+  const float lim = float(1<<20) - 1.f;
+  const float c   = std::floor(v/CellSize);
+  if(!(c>-lim))
+    return -int32_t(lim);
+  if(!(c<lim))
+    return int32_t(lim);
+  return int32_t(c);
+  }
+
+uint64_t PointGrid::cellKey(int32_t x, int32_t y, int32_t z) {
+  const uint64_t mask = (1u<<21)-1u;
+  return (uint64_t(x+(1<<20)) & mask) | ((uint64_t(y+(1<<20)) & mask)<<21) | ((uint64_t(z+(1<<20)) & mask)<<42);
+  }
+
+void PointGrid::finalize() {
+  std::sort(points.begin(), points.end());
+  valid.store(true, std::memory_order_relaxed);
+  }
+
+void PointGrid::find(const Tempest::Vec3& p, float R, std::vector<uint32_t>& out) const {
+  out.clear();
+  out.insert(out.end(), dynamic.begin(), dynamic.end());
+
+  const float   qR = R + Slack;
+  const int32_t x0 = cellCoord(p.x-qR), x1 = cellCoord(p.x+qR);
+  const int32_t y0 = cellCoord(p.y-qR), y1 = cellCoord(p.y+qR);
+  const int32_t z0 = cellCoord(p.z-qR), z1 = cellCoord(p.z+qR);
+  const uint64_t range = uint64_t(x1-x0+1)*uint64_t(y1-y0+1)*uint64_t(z1-z0+1);
+
+  if(range>=points.size()) {
+    // huge radius - every point is a candidate
+    for(auto& i:points)
+      out.push_back(i.id);
+    }
+  else {
+    for(int32_t x=x0; x<=x1; ++x)
+      for(int32_t y=y0; y<=y1; ++y)
+        for(int32_t z=z0; z<=z1; ++z) {
+          Point pt;
+          pt.key = cellKey(x,y,z);
+          auto it = std::lower_bound(points.begin(), points.end(), pt);
+          for(; it!=points.end() && it->key==pt.key; ++it)
+            out.push_back(it->id);
+          }
+    }
+  std::sort(out.begin(), out.end());
+  }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <Tempest/Point>
+
+// Snapshot of positions of array elements, bucketed into uniform grid.
+// Radius queries return indices of candidates in ascending order, so results match linear scan.
+class PointGrid final {
+  public:
+    PointGrid() = default;
+
+    // may be called from any thread, i.e. when object is teleported
+    void   invalidate() { valid.store(false, std::memory_order_relaxed); }
+    bool   isValid() const { return valid.load(std::memory_order_relaxed); }
+
+    // position(i) -> Vec3; isDynamic(i) -> true, if object moves without invalidation
+    template<class Pos, class Dyn>
+    void   build(size_t count, const Pos& position, const Dyn& isDynamic);
+
+    // candidates for sphere (p,R); objects, that have moved since build by less than 'slack' are found too
+    void   find(const Tempest::Vec3& p, float R, std::vector<uint32_t>& out) const;
+
+    static constexpr float CellSize = 1000.f;
+    static constexpr float Slack    = 500.f;
+
+  private:
+    struct Point {
+      uint64_t key = 0;
+      uint32_t id  = 0;
+      bool operator < (const Point& other) const {
+        return key<other.key || (key==other.key && id<other.id);
+        }
+      };
+
+    static int32_t  cellCoord(float v);
+    static uint64_t cellKey(int32_t x, int32_t y, int32_t z);
+    void            finalize();
+
+    std::vector<Point>    points;
+    std::vector<uint32_t> dynamic;
+    std::atomic_bool      valid{false};
+  };
+
+template<class Pos, class Dyn>
+void PointGrid::build(size_t count, const Pos& position, const Dyn& isDynamic) {
+  points.clear();
+  dynamic.clear();
+  for(size_t i=0; i<count; ++i) {
+    if(isDynamic(i)) {
+      dynamic.push_back(uint32_t(i));
+      continue;
+      }
+    const Tempest::Vec3 p = position(i);
+    Point pt;
+    pt.key = cellKey(cellCoord(p.x), cellCoord(p.y), cellCoord(p.z));
+    pt.id  = uint32_t(i);
+    points.push_back(pt);
+    }
+  finalize();
+  }
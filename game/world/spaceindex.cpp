@@ -1,132 +1,142 @@
 #include "spaceindex.h"
 
+#include <cmath>
+
 #include "world/objects/vob.h"
 
 void BaseSpaceIndex::clear() {
   arr.clear();
-  index.clear();
-  dynamic.clear();
+  entry.clear();
+  cells.clear();
+  dirty = false;
   }
 
 void BaseSpaceIndex::invalidate() {
-  index.clear();
-  dynamic.clear();
+  dirty = true;
   }
 
 void BaseSpaceIndex::add(Vob* v) {
+  Entry e;
+  e.arrId = arr.size();
   arr.push_back(v);
-  index.reserve(arr.size());
-  index.clear();
-  dynamic.clear();
+  insertCell(v, e, cellOf(*v));
+  entry[v] = e;
   }
 
 void BaseSpaceIndex::del(Vob* v) {
-  for(size_t i=0;i<arr.size();++i) {
-    if(arr[i]==v) {
-      arr[i] = arr.back();
-      arr.pop_back();
-      index.clear();
-      dynamic.clear();
-      return;
-      }
+  auto it = entry.find(v);
+  if(it==entry.end())
+    return;
+
+  const Entry e = it->second;
+  entry.erase(it);
+  eraseCell(e);
+
+  // swap with last, as before
+  if(e.arrId+1!=arr.size()) {
+    arr[e.arrId] = arr.back();
+    entry[arr[e.arrId]].arrId = e.arrId;
     }
+  arr.pop_back();
   }
 
 bool BaseSpaceIndex::hasObject(const Vob* v) const {
   if(v==nullptr)
     return false;
-  for(size_t i=0;i<arr.size();++i)
-    if(arr[i]==v)
-      return true;
-  return false;
+  return entry.find(v)!=entry.end();
   }
 
 void BaseSpaceIndex::find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(index.size()==0)
-    buildIndex();
-  for(auto& i:dynamic)
-    (*func)(ctx,i);
-  implFind(index.data(),index.size(),0,p,R,ctx,func);
-  }
+  if(dirty)
+    refresh();
 
-void BaseSpaceIndex::buildIndex() {
-  size_t cnt = 0;
-  index.resize(arr.size());
-  dynamic.clear();
-  for(size_t i=0; i<arr.size(); ++i) {
-    if(arr[i]->isDynamic()) {
-      dynamic.push_back(arr[i]);
-      } else {
-      index[cnt] = arr[i];
-      ++cnt;
-      }
+  if(auto it = cells.find(DynamicCell); it!=cells.end()) {
+    for(auto i:it->second)
+      (*func)(ctx,i);
     }
-  index.resize(cnt);
-  buildIndex(index.data(),index.size(),0);
-  }
 
-void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
-  depth%=3;
-  sort(v,cnt,depth);
-  size_t mid = cnt/2;
-  if(mid>0) {
-    // [0..mid)
-    buildIndex(v,mid,uint8_t(depth+1u));
-    }
-  if(mid+1<cnt) {
-    // (mid..cnt)
-    buildIndex(v+mid+1,cnt-mid-1,uint8_t(depth+1u));
+  const float qR = (R+675.f);//v[mid]->extendedSearchRadius());
+  auto test = [&](const Cell& c) {
+    for(auto i:c)
+      if((i->position()-p).quadLength()<=qR*qR)
+        (*func)(ctx,i);
+    };
+
+  const int32_t x0 = cellCoord(p.x-qR), x1 = cellCoord(p.x+qR);
+  const int32_t y0 = cellCoord(p.y-qR), y1 = cellCoord(p.y+qR);
+  const int32_t z0 = cellCoord(p.z-qR), z1 = cellCoord(p.z+qR);
+  const uint64_t range = uint64_t(x1-x0+1)*uint64_t(y1-y0+1)*uint64_t(z1-z0+1);
+
+  if(range>=cells.size()) {
+    // huge radius - cheaper to test every bucket
+    for(auto& [key,c]:cells)
+      if(key!=DynamicCell)
+        test(c);
+    return;
     }
+
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t y=y0; y<=y1; ++y)
+      for(int32_t z=z0; z<=z1; ++z) {
+        auto it = cells.find(cellKey(x,y,z));
+        if(it!=cells.end())
+          test(it->second);
+        }
   }
 
-void BaseSpaceIndex::sort(Vob** v, size_t cnt, uint8_t component) {
-  bool (*predicate)(const Vob* a, const Vob* b) = nullptr;
-  switch(component) {
-    case 0:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().x < b->position().x; };
-      break;
-    case 1:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().y < b->position().y; };
-      break;
-    case 2:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().z < b->position().z; };
-      break;
-    }
-  std::sort(v,v+cnt,predicate);
+int32_t BaseSpaceIndex::cellCoord(float v) {
+  // 21 bit per axis
+  const float lim = float(1<<20) - 1.f;
+  const float c   = std::floor(v/CellSize);
+  if(!(c>-lim))
+    return -int32_t(lim);
+  if(!(c<lim))
+    return int32_t(lim);
+  return int32_t(c);
   }
 
-void BaseSpaceIndex::implFind(Vob** v, size_t cnt, uint8_t depth,
-                              const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(cnt==0)
-    return;
+uint64_t BaseSpaceIndex::cellKey(int32_t x, int32_t y, int32_t z) {
+  const uint64_t mask = (1u<<21)-1u;
+  return (uint64_t(x+(1<<20)) & mask) | ((uint64_t(y+(1<<20)) & mask)<<21) | ((uint64_t(z+(1<<20)) & mask)<<42);
+  }
 
-  auto mid = cnt/2;
-  auto pos = v[mid]->position();
-  auto qR  = (R+675.0);//v[mid]->extendedSearchRadius());
+uint64_t BaseSpaceIndex::cellOf(const Vob& v) {
+  if(v.isDynamic())
+    return DynamicCell;
+  auto p = v.position();
+  return cellKey(cellCoord(p.x), cellCoord(p.y), cellCoord(p.z));
+  }
 
-  if((pos-p).quadLength()<=qR*qR) {
-    func(ctx,v[mid]);
+void BaseSpaceIndex::insertCell(Vob* v, Entry& e, uint64_t cell) {
+  auto& c  = cells[cell];
+  e.cell   = cell;
+  e.cellId = c.size();
+  c.push_back(v);
+  }
+
+void BaseSpaceIndex::eraseCell(const Entry& e) {
+  auto it = cells.find(e.cell);
+  if(it==cells.end())
+    return;
+  auto& c = it->second;
+  if(e.cellId+1!=c.size()) {
+    c[e.cellId] = c.back();
+    entry[c[e.cellId]].cellId = e.cellId;
     }
+  c.pop_back();
+  if(c.empty())
+    cells.erase(it);
+  }
 
-  depth%=3;
-  switch(depth) {
-    case 0:
-      if(p.x-qR<=pos.x)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.x+qR>=pos.x)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 1:
-      if(p.y-qR<=pos.y)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.y+qR>=pos.y)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 2:
-      if(p.z-qR<=pos.z)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.z+qR>=pos.z)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
+void BaseSpaceIndex::refresh() {
+  // move only objects, that have changed bucket
+  dirty = false;
+  for(auto v:arr) {
+    auto& e    = entry[v];
+    auto  cell = cellOf(*v);
+    if(cell==e.cell)
+      continue;
+    eraseCell(e);
+    insertCell(v, e, cell);
     }
   }
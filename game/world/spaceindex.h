@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 #include <cstdint>
 #include <algorithm>
 #include <array>
@@ -15,6 +16,7 @@ class BaseSpaceIndex {
   public:
     void   clear();
     size_t size() const { return arr.size(); }
+    // positions or dynamic-state of objects have changed
     void   invalidate();
 
   protected:
@@ -25,24 +27,38 @@ class BaseSpaceIndex {
 
     void               find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*));
     template<class Func>
-    void               parallelFor(Func f);
+    void               parallelFor(Func f, const std::source_location& loc);
     Vob**              data() { return arr.data(); }
     Vob*const*         data() const { return arr.data(); }
 
   private:
-    std::vector<Vob*>  arr;
-    std::vector<Vob*>  index;
-    std::vector<Vob*>  dynamic;
-
-    void               buildIndex();
-    void               buildIndex(Vob** v, size_t cnt, uint8_t depth);
-    void               sort(Vob** v, size_t cnt, uint8_t component);
-    void               implFind(Vob** v, size_t cnt, uint8_t depth, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    // uniform grid; objects are bucketed by position, dynamic objects live in own bucket
+    struct Entry {
+      size_t   arrId  = 0;
+      size_t   cellId = 0;
+      uint64_t cell   = 0;
+      };
+    using Cell = std::vector<Vob*>;
+
+    static constexpr float    CellSize    = 1024.f;
+    static constexpr uint64_t DynamicCell = uint64_t(-1);
+
+    std::vector<Vob*>                    arr;
+    std::unordered_map<const Vob*,Entry> entry;
+    std::unordered_map<uint64_t,Cell>    cells;
+    bool                                 dirty = false;
+
+    static int32_t     cellCoord(float v);
+    static uint64_t    cellKey(int32_t x, int32_t y, int32_t z);
+    static uint64_t    cellOf(const Vob& v);
+    void               insertCell(Vob* v, Entry& e, uint64_t cell);
+    void               eraseCell(const Entry& e);
+    void               refresh();
   };
 
 template<class Func>
-void BaseSpaceIndex::parallelFor(Func func) {
-  Workers::parallelTasks(arr,func);
+void BaseSpaceIndex::parallelFor(Func func, const std::source_location& loc) {
+  Workers::parallelTasks(arr,func,loc);
   }
 
 
@@ -78,8 +94,8 @@ class SpaceIndex final : public BaseSpaceIndex {
       }
 
     template<class F>
-    void parallelFor(F func) {
-      BaseSpaceIndex::parallelFor([&func](Vob* v){ func(*reinterpret_cast<T*>(v)); });
+    void parallelFor(F func, const std::source_location& loc = std::source_location::current()) {
+      BaseSpaceIndex::parallelFor([&func](Vob* v){ func(*reinterpret_cast<T*>(v)); }, loc);
       }
   };
 
@@ -10,6 +10,8 @@
 
 using namespace Tempest;
 
+thread_local WayMatrix::PathScratch WayMatrix::pathScratch;
+
 WayMatrix::WayMatrix(World &world, const zenkit::WayNet& dat)
   :world(world) {
 
@@ -26,8 +28,6 @@ WayMatrix::WayMatrix(World &world, const zenkit::WayNet& dat)
     edges[i] = e;
     }
 
-  stk[0].reserve(256);
-  stk[1].reserve(256);
   }
 
 void WayMatrix::buildIndex() {
@@ -39,12 +39,12 @@ void WayMatrix::buildIndex() {
     return a->name<b->name;
     });
 
-  for(auto& i:freePoints)
-    fpInd.push_back(&i);
-
-  std::sort(fpInd.begin(),fpInd.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->pos.x < b->pos.x;
-    });
+  wpGrid.build(wayPoints.size(),
+               [this](size_t i){ return wayPoints[i].pos; },
+               [](size_t){ return false; });
+  ipGrid.build(indexPoints.size(),
+               [this](size_t i){ return indexPoints[i]->position(); },
+               [](size_t){ return false; });
 
   for(auto& i:edges) {
     if(i.a<wayPoints.size() && i.b<wayPoints.size()) {
@@ -55,24 +55,35 @@ void WayMatrix::buildIndex() {
       b.connect(a);
       }
     }
+  pathCache.invalidate();
 
   calculateLadderPoints();
   }
 
 const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const std::function<bool(const WayPoint&)>& filter) const {
-  const WayPoint* ret =nullptr;
-  float           dist=std::numeric_limits<float>::max();
-  for(auto& w:wayPoints) {
-    const float l = (w.pos - at).quadLength();
-    if(l>=dist)
-      continue;
-    if(!filter(w))
-      continue;
-
-    ret  = &w;
-    dist = l;
+  // expanding search: once something is found within R, no point outside of R can be closer
+  auto& cand = candidates();
+  float R    = PointGrid::CellSize;
+  float prev = 0;
+  while(true) {
+    const WayPoint* ret  = nullptr;
+    float           dist = R*R;
+    wpGrid.find(at,R,cand);
+    for(auto id:cand) {
+      auto&       w = wayPoints[id];
+      const float l = (w.pos - at).quadLength();
+      if(l>=dist || l<prev*prev)
+        continue; // too far, or rejected by filter on previous step
+      if(!filter(w))
+        continue;
+      ret  = &w;
+      dist = l;
+      }
+    if(ret!=nullptr || cand.size()>=wayPoints.size())
+      return ret;
+    prev = R;
+    R    = R*2.f;
     }
-  return ret;
   }
 
 const WayPoint *WayMatrix::findFreePoint(const Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const {
@@ -84,9 +95,11 @@ const WayPoint *WayMatrix::findNextPoint(const Vec3& at) const {
   const WayPoint* ret   = nullptr;
   float           dist  = distanceThreshold;
 
+  auto& cand = candidates();
+  ipGrid.find(at,dist,cand);
   dist*=dist;
-  for(auto pw:indexPoints){
-    auto& w  = *pw;
+  for(auto id:cand){
+    auto& w  = *indexPoints[id];
     auto  dp = w.position()-at;
     float l  = dp.quadLength();
 
@@ -257,10 +270,9 @@ const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
       continue;
     id.index.push_back(&w);
     }
-  // TODO: good index, not sort by 'x' :)
-  std::sort(id.index.begin(),id.index.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->pos.x < b->pos.x;
-    });
+  id.grid.build(id.index.size(),
+                [&id](size_t i){ return id.index[i]->pos; },
+                [](size_t){ return false; });
 
   it = fpIndex.insert(it,std::move(id));
   return *it;
@@ -268,19 +280,14 @@ const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
 
 const WayPoint *WayMatrix::findFreePoint(const Vec3& at, const FpIndex& ind,
                                          const std::function<bool(const WayPoint&)>& filter) const {
-  float R = distanceThreshold;
-  auto b = std::lower_bound(ind.index.begin(),ind.index.end(), at.x-R ,[](const WayPoint *a, float b){
-    return a->pos.x < b;
-    });
-  auto e = std::upper_bound(ind.index.begin(),ind.index.end(), at.x+R ,[](float a,const WayPoint *b){
-    return a < b->pos.x;
-    });
+  auto& cand = candidates();
+  float R    = distanceThreshold;
+  ind.grid.find(at,R,cand);
 
   const WayPoint* ret=nullptr;
-  auto  count = std::distance(b,e);(void) count;
   float dist  = R*R;
-  for(auto i=b;i!=e;++i){
-    auto& w  = **i;
+  for(auto id:cand){
+    auto& w  = *ind.index[id];
     if(!w.isFreePoint())
       continue;
     float l = (w.pos - at).quadLength();
@@ -294,6 +301,11 @@ const WayPoint *WayMatrix::findFreePoint(const Vec3& at, const FpIndex& ind,
   return ret;
   }
 
+std::vector<uint32_t>& WayMatrix::candidates() {
+  static thread_local std::vector<uint32_t> cand;
+  return cand;
+  }
+
 WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const {
   if(beginSz==0)
     return WayPath();
@@ -309,75 +321,153 @@ WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::
     return WayPath();
     }
 
-  pathGen++;
-  if(pathGen==1){
-    // new cycle
-    for(auto& i:wayPoints)
-      i.pathGen=0;
+  bool build = false;
+  auto field = pathCache.find(uint32_t(endId),build);
+  if(field==nullptr && build) {
+    field = buildField(size_t(endId));
+    pathCache.push(uint32_t(endId),field);
     }
+  if(field!=nullptr)
+    return wayTo(begin,beginSz,exactBegin,size_t(endId),*field);
+  return wayToAStar(begin,beginSz,exactBegin,size_t(endId));
+  }
 
-  std::vector<const WayPoint*> *front=&stk[0], *back=&stk[1];
-  stk[0].clear();
-  stk[1].clear();
+WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, size_t endId,
+                         const PathCache::Field& field) const {
+  const WayPoint* first = nullptr;
+  int32_t         fLen  = std::numeric_limits<int32_t>::max();
+  for(size_t i=0; i<beginSz; ++i) {
+    intptr_t id = std::distance<const WayPoint*>(&wayPoints[0],begin[i]);
+    if(id<0 || size_t(id)>=wayPoints.size() || field.cost[size_t(id)]==std::numeric_limits<int32_t>::max())
+      continue;
+    int32_t iLen = field.cost[size_t(id)] + int((exactBegin - begin[i]->position()).length());
+    if(iLen<fLen) {
+      first = begin[i];
+      fLen  = iLen;
+      }
+    }
+  if(first==nullptr)
+    return WayPath();
+  return mkPath(*first,endId,field.parent);
+  }
 
-  end.pathLen = 0;
-  end.pathGen = pathGen;
-  front->push_back(&end);
+WayPath WayMatrix::wayToAStar(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, size_t endId) const {
+  auto& end = wayPoints[endId];
+
+  // reverse A* from 'end': each begin-point is a goal, with extra cost of distance to exactBegin
+  // Euclidean heuristic is exact for goals, so first goal taken from the queue gives shortest path
+  auto& sc = pathScratch;
+  if(sc.gen.size()!=wayPoints.size()) {
+    sc.gen   .assign(wayPoints.size(),0);
+    sc.cost  .resize(wayPoints.size());
+    sc.parent.resize(wayPoints.size());
+    sc.pass = 0;
+    }
+  sc.pass++;
+  if(sc.pass==0) {
+    // new cycle
+    std::fill(sc.gen.begin(),sc.gen.end(),0);
+    sc.pass = 1;
+    }
+  sc.heap.clear();
 
-  while(front->size()>0) {
-    bool done = true;
+  auto heuristic = [&](const WayPoint& wp) {
+    return int32_t((exactBegin - wp.position()).length());
+    };
+  auto isGoal = [&](const WayPoint* wp) {
     for(size_t i=0; i<beginSz; ++i)
-      if(begin[i]->pathGen!=pathGen) {
-        done = false;
-        break;
-        }
-    if(done)
+      if(begin[i]==wp)
+        return true;
+    return false;
+    };
+  auto cmp = [](const PathNode& a, const PathNode& b) {
+    return a.f>b.f;
+    };
+
+  sc.gen   [endId] = sc.pass;
+  sc.cost  [endId] = 0;
+  sc.parent[endId] = uint32_t(endId);
+  sc.heap.push_back({heuristic(end),uint32_t(endId)});
+
+  const WayPoint* first = nullptr;
+  while(!sc.heap.empty()) {
+    std::pop_heap(sc.heap.begin(),sc.heap.end(),cmp);
+    const PathNode n = sc.heap.back();
+    sc.heap.pop_back();
+
+    auto&   wp = wayPoints[n.id];
+    int32_t l0 = sc.cost[n.id];
+    if(n.f>l0+heuristic(wp))
+      continue; // stale entry
+    if(isGoal(&wp)) {
+      first = &wp;
       break;
+      }
 
-    for(auto& wp:*front) {
-      int32_t l0 = wp->pathLen;
-
-      for(auto i:wp->connections()){
-        auto& w  = *i.point;
-        int32_t l1 = l0+i.len;
-        if(w.pathGen!=pathGen || w.pathLen>l1){
-          w.pathLen = l1;
-          w.pathGen = pathGen;
-          back->push_back(&w);
-          }
-        }
+    for(auto i:wp.connections()) {
+      const size_t id = size_t(std::distance<const WayPoint*>(&wayPoints[0],i.point));
+      int32_t      l1 = l0+i.len;
+      if(sc.gen[id]==sc.pass && sc.cost[id]<=l1)
+        continue;
+      sc.gen   [id] = sc.pass;
+      sc.cost  [id] = l1;
+      sc.parent[id] = n.id;
+      sc.heap.push_back({l1+heuristic(*i.point),uint32_t(id)});
+      std::push_heap(sc.heap.begin(),sc.heap.end(),cmp);
       }
-    std::swap(front,back);
-    back->clear();
     }
 
-  const WayPoint* first = begin[0];
-  for(size_t i=0; i<beginSz; ++i) {
-    int32_t iLen = begin[i]->pathLen + int((exactBegin - begin[i]->position()).length());
-    int32_t fLen = first   ->pathLen + int((exactBegin - first   ->position()).length());
-    if(iLen<fLen)
-      first = begin[i];
-    }
+  if(first==nullptr)
+    return WayPath();
 
-  WayPath ret;
-  ret.add(*first);
-  const WayPoint* current = first;
-  while(current!=&end) {
-    int32_t l0 = current->pathLen, l1=l0;
-
-    const WayPoint* next=nullptr;
-    for(auto i:current->connections()){
-      if(i.point->pathGen==pathGen && i.point->pathLen+i.len<=l0 && i.point->pathLen<l1){
-        next = i.point;
-        l1   = i.point->pathLen;
-        }
+  return mkPath(*first,endId,sc.parent);
+  }
+
+std::shared_ptr<const PathCache::Field> WayMatrix::buildField(size_t endId) const {
+  // Dijkstra over whole waynet
+  auto f = std::make_shared<PathCache::Field>();
+  f->cost  .assign(wayPoints.size(),std::numeric_limits<int32_t>::max());
+  f->parent.assign(wayPoints.size(),uint32_t(endId));
+
+  auto cmp = [](const PathNode& a, const PathNode& b) {
+    return a.f>b.f;
+    };
+  std::vector<PathNode> heap;
+  f->cost[endId] = 0;
+  heap.push_back({0,uint32_t(endId)});
+  while(!heap.empty()) {
+    std::pop_heap(heap.begin(),heap.end(),cmp);
+    const PathNode n = heap.back();
+    heap.pop_back();
+    if(n.f>f->cost[n.id])
+      continue; // stale entry
+
+    for(auto i:wayPoints[n.id].connections()) {
+      const size_t id = size_t(std::distance<const WayPoint*>(&wayPoints[0],i.point));
+      int32_t      l1 = n.f+i.len;
+      if(f->cost[id]<=l1)
+        continue;
+      f->cost  [id] = l1;
+      f->parent[id] = n.id;
+      heap.push_back({l1,uint32_t(id)});
+      std::push_heap(heap.begin(),heap.end(),cmp);
       }
-    if(next==nullptr)
-      return WayPath();
-    ret.add(*next);
-    current=next;
     }
+  return f;
+  }
 
+WayPath WayMatrix::mkPath(const WayPoint& first, size_t endId, const std::vector<uint32_t>& parent) const {
+  WayPath ret;
+  size_t  current = size_t(std::distance<const WayPoint*>(&wayPoints[0],&first));
+  ret.add(first);
+  while(current!=endId) {
+    current = parent[current];
+    ret.add(wayPoints[current]);
+    }
   ret.reverse();
   return ret;
   }
+
+PathCache::Stat WayMatrix::pathStat() const {
+  return pathCache.stat();
+  }
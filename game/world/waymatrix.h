@@ -6,8 +6,11 @@
 #include <zenkit/world/WayNet.hh>
 
 #include <vector>
+#include <memory>
 #include <functional>
 
+#include "pathcache.h"
+#include "pointgrid.h"
 #include "waypath.h"
 #include "waypoint.h"
 
@@ -34,6 +37,7 @@ class WayMatrix final {
     void            marchPoints(DbgPainter& p) const;
 
     WayPath         wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const;
+    PathCache::Stat pathStat() const;
 
   private:
     struct WayEdge {
@@ -57,16 +61,39 @@ class WayMatrix final {
     std::vector<WayPoint>  freePoints, startPoints;
     std::vector<WayPoint*> indexPoints;
 
-    std::vector<WayPoint*> fpInd;
+    PointGrid              wpGrid; // indices of wayPoints
+    PointGrid              ipGrid; // indices of indexPoints
 
     struct FpIndex {
       std::string                  key;
       std::vector<const WayPoint*> index;
+      PointGrid                    grid;
       };
     mutable std::vector<FpIndex>          fpIndex;
 
-    mutable uint16_t                      pathGen=0;
-    mutable std::vector<const WayPoint*>  stk[2];
+    struct PathNode {
+      int32_t  f  = 0;
+      uint32_t id = 0;
+      };
+
+    // per-thread search state, wayTo is reentrant
+    struct PathScratch {
+      std::vector<uint32_t> gen;
+      std::vector<int32_t>  cost;
+      std::vector<uint32_t> parent;
+      std::vector<PathNode> heap;
+      uint32_t              pass = 0;
+      };
+    static thread_local PathScratch       pathScratch;
+    mutable PathCache                     pathCache;
+
+    static std::vector<uint32_t>& candidates();
+
+    WayPath                wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, size_t endId,
+                                 const PathCache::Field& field) const;
+    WayPath                wayToAStar(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, size_t endId) const;
+    auto                   buildField(size_t endId) const -> std::shared_ptr<const PathCache::Field>;
+    WayPath                mkPath(const WayPoint& first, size_t endId, const std::vector<uint32_t>& parent) const;
 
     void                   adjustWaypoints(std::vector<WayPoint> &wp);
     void                   calculateLadderPoints();
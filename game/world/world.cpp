@@ -2,6 +2,8 @@
 
 #include <functional>
 #include <future>
+#include <unordered_set>
+#include <atomic>
 #include <cctype>
 
 #include <Tempest/Log>
@@ -18,6 +20,8 @@
 #include "game/globaleffects.h"
 #include "game/serialize.h"
 #include "utils/string_frm.h"
+#include "utils/fileext.h"
+#include "utils/workers.h"
 #include "gothic.h"
 #include "focus.h"
 #include "resources.h"
@@ -63,6 +67,68 @@ const char* materialTag(zenkit::MaterialGroup src) {
   return "UD";
   }
 
+static void collectVisuals(const zenkit::VirtualObject& vob, std::unordered_set<std::string>& mesh,
+                           std::vector<const zenkit::VisualDecal*>& decal) {
+  // mirrors ObjVisual::setVisual
+  if(vob.visual!=nullptr && !vob.visual->name.empty()) {
+    switch(vob.visual->type) {
+      case zenkit::VisualType::MESH:
+      case zenkit::VisualType::MULTI_RESOLUTION_MESH:
+        mesh.emplace(vob.visual->name);
+        break;
+      case zenkit::VisualType::MODEL:
+      case zenkit::VisualType::MORPH_MESH: {
+        auto visual = vob.visual->name;
+        FileExt::exchangeExt(visual,"ASC","MDL");
+        mesh.emplace(std::move(visual));
+        break;
+        }
+      case zenkit::VisualType::DECAL:
+        if(vob.sprite_camera_facing_mode!=zenkit::SpriteAlignment::NONE)
+          break;
+        if(auto d = dynamic_cast<const zenkit::VisualDecal*>(vob.visual.get()))
+          decal.push_back(d);
+        break;
+      case zenkit::VisualType::PARTICLE_EFFECT:
+      case zenkit::VisualType::AI_CAMERA:
+      case zenkit::VisualType::UNKNOWN:
+        break;
+      }
+    }
+
+  for(auto& i:vob.children)
+    collectVisuals(*i, mesh, decal);
+  }
+
+static void prefetchVisuals(const std::vector<std::shared_ptr<zenkit::VirtualObject>>& vobs) {
+  // load meshes (with textures and collision shapes) in parallel; insertion of vobs later on hits the cache.
+  // NOTE: per-vob PhysicMesh bodies are still created on insertion - DynamicWorld is not thread-safe
+  std::unordered_set<std::string>         uniq;
+  std::vector<const zenkit::VisualDecal*> decal;
+  for(auto& vob:vobs)
+    collectVisuals(*vob, uniq, decal);
+
+  std::vector<std::string> mesh(uniq.begin(), uniq.end());
+  std::atomic_size_t       next{0};
+  const size_t             total = mesh.size() + decal.size();
+
+  // one-shot work, no point in cost-model of parallelFor: all workers at once
+  Workers::parallelTasks(Workers::maxThreads()+1, [&](size_t) {
+    while(true) {
+      const size_t i = next.fetch_add(1);
+      if(i>=total)
+        break;
+      // NOTE: errors are not fatal here - same load is repeated, when vob is inserted
+      try {
+        if(i<mesh.size())
+          Resources::loadMesh(mesh[i]); else
+          Resources::decalMesh(*decal[i-mesh.size()]);
+        }
+      catch(...) {}
+      }
+    });
+  }
+
 World::World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress)
   :wname(std::move(file)), game(game), wsound(game,*this), wobj(*this) {
   const auto* entry = Resources::vdfsIndex().find(wname);
@@ -90,6 +156,10 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
       PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
       return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
       });
+    auto prefetchFut = std::async(std::launch::async, [&]() {
+      Workers::setThreadName("Loading: Vob visuals thread");
+      prefetchVisuals(world.world_vobs);
+      });
 
     loadProgress(30);
 
@@ -108,6 +178,9 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
     wdynamic = wdynamicFut.get();
     loadProgress(70);
 
+    prefetchFut.get();
+    loadProgress(80);
+
     globFx.reset(new GlobalEffects(*this));
     wmatrix.reset(new WayMatrix(*this, *world.way_net));
     for(auto& vob:world.world_vobs)
@@ -816,6 +889,14 @@ void World::addTrigger(AbstractTrigger* trigger) {
   wobj.addTrigger(trigger);
   }
 
+WorldObjects::TriggerStat World::triggerStat() const {
+  return wobj.triggerStat();
+  }
+
+PathCache::Stat World::pathStat() const {
+  return wmatrix->pathStat();
+  }
+
 void World::addInteractive(Interactive* inter) {
   wobj.addInteractive(inter);
   }
@@ -981,6 +1062,10 @@ void World::detectNpc(const Tempest::Vec3& p, const float r, const std::function
   wobj.detectNpc(p.x,p.y,p.z,r,f);
   }
 
+void World::invalidateNpcGrid() {
+  wobj.invalidateNpcGrid();
+  }
+
 void World::detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f) {
   wobj.detectItem(p.x,p.y,p.z,r,f);
   }
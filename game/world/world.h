@@ -73,6 +73,7 @@ class World final {
     void                 detectNpcNear(std::function<void(Npc&)> f);
     void                 detectNpc (const Tempest::Vec3& p, const float r, const std::function<void(Npc&)>& f);
     void                 detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f);
+    void                 invalidateNpcGrid();
 
     WayPath              wayTo(const Npc& pos,const WayPoint& end) const;
 
@@ -185,6 +186,8 @@ class World final {
     Sound                addLandHitEffect  (ItemMaterial src, zenkit::MaterialGroup reciver, const Tempest::Matrix4x4& pos);
 
     void                 addTrigger    (AbstractTrigger* trigger);
+    auto                 triggerStat() const -> WorldObjects::TriggerStat;
+    auto                 pathStat() const -> PathCache::Stat;
     void                 addInteractive(Interactive* inter);
     void                 addStartPoint (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addFreePoint  (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
@@ -14,14 +14,22 @@
 #include "world.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
+#include "camera.h"
 #include "gothic.h"
 
 #include <Tempest/Painter>
 #include <Tempest/Application>
 #include <Tempest/Log>
 
+#include <cassert>
+#include <chrono>
+#include <limits>
+
 using namespace Tempest;
 
+// longest single npc tick, see tickSliced
+static const uint64_t tickStep = 100;
+
 int32_t WorldObjects::MobStates::stateByTime(gtime t) const {
   t = t.timeInDay();
   for(size_t i=routines.size(); i>0; ) {
@@ -73,6 +81,8 @@ void WorldObjects::load(Serialize &fin) {
   }
   itemArr.clear();
   items.clear();
+  itemGrid.invalidate();
+  npcGrid.invalidate();
 
   uint32_t sz = fin.directorySize("worlds/",fin.worldName(),"/npc/");
   npcArr.resize(sz);
@@ -167,18 +177,51 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     std::sort(npcArr.begin(),npcArr.end(),[](std::unique_ptr<Npc>& a, std::unique_ptr<Npc>& b){
       return a->handle().id<b->handle().id;
       });
+    npcGrid.invalidate();
     }
 
   auto       camera  = Gothic::inst().camera();
   const bool freeCam = (camera!=nullptr && camera->isFree());
   const auto pl      = owner.player();
+
+  // compute phase: per-npc work against state of frame start; tick below applies it in npc-id order
+  const int32_t diveTick = owner.script().npcDamDiveTime();
+  tickQueue.clear();
+  for(auto& i:npcArr) {
+    auto& npc = *i;
+    if(pl==&npc) {
+      if(!freeCam)
+        tickQueue.push_back({&npc,dtPlayer});
+      continue;
+      }
+    if(npc.processPolicy()>=NpcProcessPolicy::AiFar)
+      continue;
+    tickQueue.push_back({&npc,std::min(dt + npc.deferredTime(), tickStep)});
+    }
+  owner.physic()->updateAabbs();
+  Workers::parallelFor(tickQueue,[diveTick](TickItem& i) {
+    i.npc->tickCompute(i.dt,diveTick);
+    });
+#ifndef NDEBUG
+  tickReplayCheck(diveTick);
+#endif
+
   for(size_t i=0; i<npcArr.size(); ++i) {
     auto& npc = *npcArr[i];
-    uint64_t d = (pl==&npc ? dtPlayer : dt);
-    if(freeCam && pl==&npc)
+    if(pl==&npc) {
+      if(!freeCam)
+        npc.tick(dtPlayer);
       continue;
-    npc.tick(d);
+      }
+    if(npc.processPolicy()>=NpcProcessPolicy::AiFar) {
+      npc.deferTick(dt);
+      continue;
+      }
+    tickSliced(npc,dt + npc.takeDeferredTime());
     }
+  tickFar();
+  // npc's have moved - refresh grid for detectNpc
+  updateNpcGrid();
 
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
@@ -188,9 +231,12 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       }
     }
 
-  collisionZn.erase(std::remove_if(collisionZn.begin(), collisionZn.end(), [](CollisionZone* b){
-    return b==nullptr;
-    }), collisionZn.end());
+  if(collisionZnRemoved) {
+    collisionZn.erase(std::remove_if(collisionZn.begin(), collisionZn.end(), [](CollisionZone* b){
+      return b==nullptr;
+      }), collisionZn.end());
+    collisionZnRemoved = false;
+    }
 
   for(CollisionZone* z:collisionZn)
     z->tick(dt);
@@ -246,6 +292,18 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   if(pl==nullptr)
     return;
 
+  // line-of-sight queries are independent, and can run in parallel; scripts are invoked strictly in order below
+  percQueue.clear();
+  for(auto& ptr:npcNear) {
+    if(ptr->isPlayer() || ptr->isDead())
+      continue;
+    if(ptr->percNextTime()<=owner.tickCount())
+      percQueue.push_back(ptr);
+    }
+  Workers::parallelFor(percQueue,[pl](Npc* i) {
+    i->perceptionPrefetch(*pl);
+    });
+
   for(auto& ptr:npcNear) {
     Npc& i = *ptr;
     if(i.isPlayer() || i.isDead())
@@ -303,6 +361,7 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
     npc->updateTransform();
     owner.script().invokeRefreshAtInsert(*npc);
     npcArr.emplace_back(npc);
+    npcGrid.invalidate();
     } else {
     const auto* sym = owner.script().findSymbol(npcInstance);
     Log::e("addNpc: ", npcInstance, " (", (sym!=nullptr ? sym->name() : "nullptr" ), ") has invalid spawnpoint (", at, ")");
@@ -329,6 +388,7 @@ Npc* WorldObjects::addNpc(size_t npcInstance, const Vec3& pos) {
   owner.script().invokeRefreshAtInsert(*npc);
 
   npcArr.emplace_back(npc);
+  npcGrid.invalidate();
   return npc;
   }
 
@@ -350,6 +410,7 @@ Npc* WorldObjects::insertPlayer(std::unique_ptr<Npc> &&npc, std::string_view at)
   npc->attachToPoint(pos);
   npc->updateTransform();
   npcArr.emplace_back(std::move(npc));
+  npcGrid.invalidate();
   return npcArr.back().get();
   }
 
@@ -359,6 +420,7 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
     if(&npc==ptr){
       auto ret=std::move(npcArr[i]);
       npcArr.erase(npcArr.begin() + int32_t(i));
+      npcGrid.invalidate();
       return ret;
       }
     }
@@ -376,10 +438,94 @@ void WorldObjects::removeNpc(Npc& npc) {
   npcRemoved.emplace_back(std::move(ptr));
   }
 
+void WorldObjects::tickFar() {
+  // far npc's run at reduced rate with accumulated dt, round-robin, while per-frame budget lasts
+  // npc's, that have been skipped for too long, are processed regardless of budget - keeps routines on time
+  static const uint64_t maxDefer = 1000;
+
+  auto&      opt    = Gothic::options();
+  const auto start  = std::chrono::steady_clock::now();
+  const auto budget = std::chrono::microseconds(opt.aiFarBudget);
+  const auto count  = npcArr.size();
+  if(count==0)
+    return;
+
+  size_t next = farCursor%count;
+  size_t from = next;
+  bool   over = false;
+  for(size_t r=0; r<count; ++r) {
+    const size_t id = (from+r)%count;
+    if(id>=npcArr.size())
+      continue;
+    auto& npc = *npcArr[id];
+    if(npc.processPolicy()<NpcProcessPolicy::AiFar)
+      continue;
+
+    const uint64_t interval = (npc.processPolicy()==NpcProcessPolicy::AiFar ? opt.aiFarInterval : opt.aiFar2Interval);
+    const uint64_t pending  = npc.deferredTime();
+    if(pending<interval || (over && pending<maxDefer))
+      continue;
+
+    tickSliced(npc,npc.takeDeferredTime());
+    if(!over) {
+      next = id+1;
+      over = (std::chrono::steady_clock::now()-start)>=budget;
+      }
+    }
+  farCursor = next;
+  }
+
+void WorldObjects::tickSliced(Npc& npc, uint64_t dt) {
+  // accumulated time of far npc is replayed in small steps: one large dt would overshoot movement
+  // and drain only a single ai-action, while same time in normal ticks drains many
+  while(dt>tickStep) {
+    npc.tick(tickStep);
+    dt -= tickStep;
+    }
+  npc.tick(dt);
+  }
+
+void WorldObjects::tickReplayCheck(int32_t diveTick) const {
+  // compute phase must not depend on scheduling: serial replay has to give bit-identical result
+  [[maybe_unused]] bool ok = true;
+  for(auto& i:tickQueue) {
+    if(i.npc->tickComputeCheck(i.dt,diveTick))
+      continue;
+    Log::e("tick: parallel compute differs from serial replay, npc: \"", i.npc->displayName(), "\"");
+    ok = false;
+    }
+  assert(ok);
+  }
+
 void WorldObjects::tickNear(uint64_t /*dt*/) {
+  if(collisionZn.empty())
+    return;
+
+  const size_t count = collisionZn.size();
+  zoneGrid.clear();
+  for(size_t r=0; r<count; ++r) {
+    if(collisionZn[r]==nullptr)
+      continue;
+    Vec3 bmin, bmax;
+    collisionZn[r]->bounds(bmin,bmax);
+    zoneGrid.insert(uint32_t(r),bmin,bmax);
+    }
+  zoneGrid.finalize();
+
+  std::vector<uint32_t> hit;
   for(Npc* i:npcNear) {
-    // note collisionZn might be changed by callbacks - need to be careful
-    for(size_t r=0; r<collisionZn.size(); ++r) {
+    Vec3 bmin, bmax;
+    CollisionZone::bounds(*i,bmin,bmax);
+    zoneGrid.find(bmin,bmax,hit);
+
+    // note collisionZn might be changed by callbacks - need to be careful:
+    // removed zones are null, new zones are appended past 'count' and not in grid
+    for(auto r:hit) {
+      CollisionZone* z = collisionZn[r];
+      if(z!=nullptr && z->checkPos(*i))
+        z->onIntersect(*i);
+      }
+    for(size_t r=count; r<collisionZn.size(); ++r) {
       CollisionZone* z = collisionZn[r];
       if(z!=nullptr && z->checkPos(*i))
         z->onIntersect(*i);
@@ -392,13 +538,22 @@ void WorldObjects::triggerEvent(const TriggerEvent &e) {
   }
 
 void WorldObjects::tickTriggers(uint64_t /*dt*/) {
+  evtDispatchedLast = evtDispatched;
+  evtDispatched     = 0;
+
   execDelayedEvents();
 
   auto evt = std::move(triggerEvents);
   triggerEvents.clear();
 
-  for(auto& e:evt)
+  for(auto& e:evt) {
+    if(e.timeBarrier>owner.tickCount()) {
+      // not ready yet - keep in queue without lookup
+      triggerEvents.push_back(std::move(e));
+      continue;
+      }
     owner.execTriggerEvent(e);
+    }
   }
 
 void WorldObjects::execDelayedEvents() {
@@ -412,17 +567,18 @@ void WorldObjects::execDelayedEvents() {
   }
 
 bool WorldObjects::execTriggerEvent(const TriggerEvent& e) {
-  bool emitted=false;
+  ++evtDispatched;
 
-  for(auto& i:triggers) {
-    auto& t = *i;
-    if(t.name()!=e.target)
-      continue; // NOTE: trigger name is not unique - more then one trigger can be activated
-    t.processEvent(e);
-    emitted = true;
-    }
+  auto it = triggerByName.find(e.target);
+  if(it==triggerByName.end())
+    return false;
 
-  return emitted;
+  // NOTE: trigger name is not unique - more then one trigger can be activated
+  // index-based: handler may add new triggers
+  auto& list = it->second;
+  for(size_t i=0; i<list.size(); ++i)
+    list[i]->processEvent(e);
+  return !list.empty();
   }
 
 void WorldObjects::updateAnimation(uint64_t dt) {
@@ -431,12 +587,57 @@ void WorldObjects::updateAnimation(uint64_t dt) {
     return;
   if(dt==0)
     return;
-  Workers::parallelTasks(npcArr,[dt](std::unique_ptr<Npc>& i){
-    i->updateAnimation(dt);
+
+  AnimLod lod;
+  lod.setup(Gothic::inst().camera());
+
+  auto mobsi = Workers::spawn([this,dt,&lod](){
+    interactiveObj.parallelFor([dt,&lod](Interactive& i){
+      bool skipMinor = false;
+      auto interval  = lod.interval(i.position(),false,i.needsBones(),skipMinor);
+      i.setAnimLod(interval,skipMinor);
+      i.updateAnimation(dt);
+      });
     });
-  interactiveObj.parallelFor([dt](Interactive& i){
-    i.updateAnimation(dt);
+  Workers::parallelTasks(npcArr,[dt,&lod](std::unique_ptr<Npc>& i){
+    bool skipMinor = false;
+    auto interval  = lod.interval(i->position(),i->isPlayer(),i->needsBones(),skipMinor);
+    i->setAnimLod(interval,skipMinor);
+    i->updateAnimation(dt);
     });
+  Workers::wait(mobsi);
+  }
+
+void WorldObjects::AnimLod::setup(const Camera* camera) {
+  if(camera==nullptr)
+    return;
+  auto& opt = Gothic::options();
+  eye       = camera->listenerPosition().pos;
+  frustrum.make(camera->viewProj(),1,1);
+  nearDist  = float(opt.animLodNear);
+  farDist   = float(opt.animLodFar);
+  valid     = nearDist>0;
+  }
+
+uint64_t WorldObjects::AnimLod::interval(const Tempest::Vec3& pos, bool player, bool needsBones, bool& skipMinor) const {
+  // radius of object, with margin for shadows of off-screen characters
+  static const float R = 300.f;
+
+  skipMinor = false;
+  if(!valid || player)
+    return 0;
+  const float qDist = (pos-eye).quadLength();
+  if(qDist<nearDist*nearDist)
+    return 0;
+
+  auto& opt = Gothic::options();
+  skipMinor = true;
+  // frozen skeleton is only safe, while no gameplay code reads its bones
+  if(opt.animLodFreeze && !needsBones && !frustrum.testPoint(pos,R))
+    return std::numeric_limits<uint64_t>::max();
+  if(qDist<farDist*farDist)
+    return opt.animLodInterval;
+  return opt.animLodFarInterval;
   }
 
 bool WorldObjects::isTargeted(Npc& dst) {
@@ -495,26 +696,72 @@ void WorldObjects::detectNpcNear(const std::function<void(Npc&)>& f) {
 
 void WorldObjects::detectNpc(const float x, const float y, const float z,
                              const float r, const std::function<void(Npc&)>& f) {
+  if(!npcGrid.isValid())
+    updateNpcGrid();
+
+  // take scratch buffer, so nested calls from callback get own one
+  auto hit = std::move(detectScratch());
+  npcGrid.find(Vec3(x,y,z),r,hit);
+
   float maxDist=r*r;
-  for(auto& i:npcArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
+  for(auto id:hit) {
+    if(id>=npcArr.size())
+      break;
+    auto& i     = npcArr[id];
+    auto  qDist = (i->position()-Vec3(x,y,z)).quadLength();
     if(qDist<maxDist)
       f(*i);
     }
+  detectScratch() = std::move(hit);
   }
 
 void WorldObjects::detectItem(const float x, const float y, const float z,
                               const float r, const std::function<void(Item&)>& f) {
+  if(!itemGrid.isValid()) {
+    itemGrid.build(itemArr.size(),
+                   [this](size_t i){ return itemArr[i]->position();  },
+                   [this](size_t i){ return itemArr[i]->isDynamic(); });
+    }
+
+  auto hit = std::move(detectScratch());
+  itemGrid.find(Vec3(x,y,z),r,hit);
+
   float maxDist=r*r;
-  for(auto& i:itemArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
+  for(auto id:hit) {
+    if(id>=itemArr.size())
+      break;
+    auto& i     = itemArr[id];
+    auto  qDist = (i->position()-Vec3(x,y,z)).quadLength();
     if(qDist<maxDist)
       f(*i);
     }
+  detectScratch() = std::move(hit);
+  }
+
+std::vector<uint32_t>& WorldObjects::detectScratch() {
+  static thread_local std::vector<uint32_t> hit;
+  return hit;
+  }
+
+void WorldObjects::updateNpcGrid() {
+  for(auto& i:npcArr)
+    i->syncGridPosition();
+  npcGrid.build(npcArr.size(),
+                [this](size_t i){ return npcArr[i]->position(); },
+                [](size_t){ return false; });
   }
 
 void WorldObjects::addTrigger(AbstractTrigger* tg) {
   triggers.emplace_back(tg);
+  triggerByName[std::string(tg->name())].push_back(tg);
+  }
+
+WorldObjects::TriggerStat WorldObjects::triggerStat() const {
+  TriggerStat st;
+  st.triggers   = triggers.size();
+  st.names      = triggerByName.size();
+  st.dispatched = evtDispatchedLast;
+  return st;
   }
 
 void WorldObjects::enableDefTrigger(AbstractTrigger& t) {
@@ -568,6 +815,7 @@ void WorldObjects::disableCollizionZone(CollisionZone& z) {
   for(auto& i:collisionZn)
     if(i==&z) {
       i = nullptr;
+      collisionZnRemoved = true;
       return;
       }
   }
@@ -606,6 +854,7 @@ std::unique_ptr<Item> WorldObjects::takeItem(Item &it) {
       i = std::move(itemArr.back());
       itemArr.pop_back();
       items.del(ret.get());
+      itemGrid.invalidate();
       ret->setPhysicsDisable();
       onItemRemoved(*ret);
       return ret;
@@ -671,6 +920,7 @@ Item* WorldObjects::addItem(size_t itemInstance, const Tempest::Vec3& pos, const
   auto* it=ptr.get();
   itemArr.emplace_back(std::move(ptr));
   items.add(itemArr.back().get());
+  itemGrid.invalidate();
 
   it->setPosition (pos.x, pos.y, pos.z);
   it->setDirection(dir.x, dir.y, dir.z);
@@ -694,6 +944,7 @@ Item* WorldObjects::addItemDyn(size_t itemInstance, const Tempest::Matrix4x4& po
   it->handle().owner = ownerNpc==size_t(-1) ? 0 : int32_t(ownerNpc);
   itemArr.emplace_back(std::move(ptr));
   items.add(itemArr.back().get());
+  itemGrid.invalidate();
 
   it->setObjMatrix(pos);
 
@@ -717,6 +968,7 @@ void WorldObjects::addRoot(const std::shared_ptr<zenkit::VirtualObject>& vob, bo
 
 void WorldObjects::invalidateVobIndex() {
   items.invalidate();
+  itemGrid.invalidate();
   interactiveObj.invalidate();
   }
 
@@ -1000,6 +1252,7 @@ void WorldObjects::resetPositionToTA() {
       npc.updateTransform();
       }
     }
+  npcGrid.invalidate();
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
     i.curState = s;
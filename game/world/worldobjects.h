@@ -2,11 +2,16 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <string>
 
 #include <zenkit/vobs/Misc.hh>
 
 #include "bullet.h"
 #include "spaceindex.h"
+#include "pointgrid.h"
+#include "aabbgrid.h"
+#include "graphics/dynamic/frustrum.h"
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
@@ -22,6 +27,7 @@ class TriggerEvent;
 class AbstractTrigger;
 class CsCamera;
 class CollisionZone;
+class Camera;
 
 class WorldObjects final {
   public:
@@ -67,6 +73,7 @@ class WorldObjects final {
     void           detectNpcNear(const std::function<void(Npc&)>& f);
     void           detectNpc (const float x, const float y, const float z, const float r, const std::function<void(Npc&)>&  f);
     void           detectItem(const float x, const float y, const float z, const float r, const std::function<void(Item&)>& f);
+    void           invalidateNpcGrid() { npcGrid.invalidate(); }
 
     uint32_t       npcId(const Npc *ptr) const;
     size_t         npcCount()    const { return npcArr.size(); }
@@ -84,7 +91,14 @@ class WorldObjects final {
     void           setCurrentCs(CsCamera* cs);
     CsCamera*      currentCs() const;
 
+    struct TriggerStat {
+      size_t         triggers   = 0;
+      size_t         names      = 0;
+      uint32_t       dispatched = 0; // events, dispatched during last frame
+      };
+
     void           addTrigger(AbstractTrigger* trigger);
+    auto           triggerStat() const -> TriggerStat;
     void           enableDefTrigger(AbstractTrigger& trigger);
     void           triggerEvent(const TriggerEvent& e);
     bool           triggerOnStart(bool firstTime);
@@ -157,13 +171,33 @@ class WorldObjects final {
       uint64_t timeUntil = 0;
       };
 
+    struct TickItem {
+      Npc*     npc = nullptr;
+      uint64_t dt  = 0; // first tick of npc in this frame
+      };
+
+    // animation level of detail: sampling interval by distance to camera and visibility
+    struct AnimLod {
+      Tempest::Vec3 eye;
+      Frustrum      frustrum;
+      float         nearDist = 0;
+      float         farDist  = 0;
+      bool          valid    = false;
+
+      void     setup(const Camera* camera);
+      uint64_t interval(const Tempest::Vec3& pos, bool player, bool needsBones, bool& skipMinor) const;
+      };
+
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
+    bool                               collisionZnRemoved = false;
+    AabbGrid                           zoneGrid; // indices of collisionZn, for tickNear
     std::vector<std::unique_ptr<Vob>>  rootVobs;
 
     SpaceIndex<Interactive>            interactiveObj;
     SpaceIndex<Item>                   items;
+    PointGrid                          itemGrid; // indices of itemArr, for detectItem
 
     std::vector<StaticObj*>            objStatic;
     std::vector<std::unique_ptr<Item>> itemArr;
@@ -176,12 +210,19 @@ class WorldObjects final {
     std::vector<std::unique_ptr<Npc>>  npcInvalid; // dead or invalid TA
     std::vector<std::unique_ptr<Npc>>  npcRemoved; // removed, but may have a dangling references in game
     std::vector<Npc*>                  npcNear;
+    std::vector<TickItem>              tickQueue; // npc's, ticked at full rate this frame
+    std::vector<Npc*>                  percQueue; // npcNear, due for perception this tick
+    size_t                             farCursor = 0; // round-robin position for tickFar
+    PointGrid                          npcGrid;  // indices of npcArr, for detectNpc
 
     std::vector<AbstractTrigger*>      triggers;
+    std::unordered_map<std::string,std::vector<AbstractTrigger*>> triggerByName; // NOTE: trigger name is not unique
     std::vector<AbstractTrigger*>      triggersTk;
     std::vector<AbstractTrigger*>      triggersDef;
     std::vector<PerceptionMsg>         sndPerc;
     std::vector<TriggerEvent>          triggerEvents;
+    uint32_t                           evtDispatched     = 0;
+    uint32_t                           evtDispatchedLast = 0;
     CsCamera*                          currentCsCamera = nullptr;
 
     template<class T>
@@ -196,6 +237,11 @@ class WorldObjects final {
     void             passivePerceptionProcess(PerceptionMsg& msg, Npc& npc, Npc& pl);
 
     void             tickNear(uint64_t dt);
+    void             tickFar();
+    void             tickSliced(Npc& npc, uint64_t dt);
+    void             tickReplayCheck(int32_t diveTick) const;
+    void             updateNpcGrid();
+    static std::vector<uint32_t>& detectScratch();
     void             tickTriggers(uint64_t dt);
     static bool      isTargetedBy(Npc& npc,Npc& by);
   };